@@ -1,9 +1,67 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define MAX_SIZE 19
+#define MAX_DIAG (2 * MAX_SIZE - 1)
+
+//칸 배치: 보드 크기와 상관없이 한 줄 STRIDE 칸의 1차원 배열
+//칸 번호 = (x + 1) * STRIDE + y + 1. 보드 둘레(위아래 한 줄, 줄마다 왼쪽 한 칸,
+//크기 밖의 열)는 모두 벽(WALL)이라, 어느 칸에서 어느 방향으로 한 칸 가도 배열 안이다
+#define STRIDE (MAX_SIZE + 1)
+#define BOARD_CELLS 448                     //(MAX_SIZE + 2) * STRIDE + 1 을 캐시 라인(64) 단위로
+#define POS(x, y) (((x) + 1) * STRIDE + (y) + 1)
+#define POS_X(pos) ((pos) / STRIDE - 1)
+#define POS_Y(pos) ((pos) % STRIDE - 1)
+
+#define EMPTY ' '
+#define WALL '#'
+
+//라인 비트보드: 돌 색깔마다 가로/세로/대각선 한 줄을 비트마스크 하나로 들고 있다
+//가로 rows[x] 의 비트 y, 세로 cols[y] 의 비트 x,
+//↘ 대각선 diag[x - y + MAX_SIZE - 1] 의 비트 x, ↙ 대각선 anti[x + y] 의 비트 x
+typedef struct
+{
+    unsigned int rows[MAX_SIZE];
+    unsigned int cols[MAX_SIZE];
+    unsigned int diag[MAX_DIAG];
+    unsigned int anti[MAX_DIAG];
+} LineBits;
+
+//보드: 칸 배열과 그에 딸린 증분 상태를 한 구조체로 (복사 한 번으로 국면 전체가 넘어간다)
+typedef struct
+{
+    int size;
+    int stoneCount;                 //보드에 놓인 돌 수
+    int evalTotal;                  //모든 창 점수 합 (X 입장)
+    unsigned long long zobristKey;  //현재 국면 키
+    LineBits lineBits[2];           //0: X, 1: O
+    char cells[BOARD_CELLS];
+} Board;
+
+static int winLength = 5;       //이겨야 하는 연속 돌 수 (5, 보드가 더 작으면 보드 크기)
+
+//자주 쓰는 크기(15, 19)는 크기를 상수로 넘겨 컴파일러가 반복 횟수와 경계를 미리 계산하게 한다
+#define SIZE_DISPATCH(size, fn, ...) \
+    ((size) == 15 ? fn(15, __VA_ARGS__) : (size) == 19 ? fn(19, __VA_ARGS__) : fn((size), __VA_ARGS__))
+
+//Zobrist 해시: 칸마다 색깔별 난수, 보드 크기별 난수를 XOR 해 국면 키를 만든다
+//placeStone/removeStone 이 둘 때마다 한 번씩 XOR 해서 키를 갱신한다
+static unsigned long long zobristStone[2][BOARD_CELLS];
+static unsigned long long zobristSize[MAX_SIZE + 1];
 
 
 //보드 출력 함수
-void printBoard(int SIZE, char board[SIZE][SIZE])
+void printBoard(const Board *b)
 {
+    int SIZE = b->size;
     printf("\n");
     printf("   ");  // 왼쪽 여백
     for (int j = 0; j < SIZE; j++)
@@ -15,7 +73,7 @@ void printBoard(int SIZE, char board[SIZE][SIZE])
         printf("%2d ", i + 1);  // 행 번호 출력
         for (int j=0; j<SIZE; j++)
         {
-            printf(" %c ", board[i][j]);
+            printf(" %c ", b->cells[POS(i, j)]);
             if (j < SIZE-1)    printf("|");
         }
         printf("\n");
@@ -34,36 +92,2124 @@ void printBoard(int SIZE, char board[SIZE][SIZE])
     printf("\n");
 }
 
+//splitmix64: 고정 시드로 Zobrist 난수를 만든다 (실행마다 같은 키)
+static unsigned long long splitmix64(unsigned long long *state)
+{
+    unsigned long long z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+//Zobrist 표 채우기 (프로그램 시작 시 한 번, 3~19 모든 크기 공용)
+void initZobrist(void)
+{
+    unsigned long long state = 0x6F6D6F6Bull;
+    for (int p = 0; p < 2; p++)
+        for (int pos = 0; pos < BOARD_CELLS; pos++)
+            zobristStone[p][pos] = splitmix64(&state);
+    for (int size = 0; size <= MAX_SIZE; size++)
+        zobristSize[size] = splitmix64(&state);
+}
+
+//패턴 평가: 라인 위 (winLength + 1)칸 창을 3진수(빈칸 0, 내 돌 1, 상대 돌/보드 밖 2)로 읽어
+//미리 만든 표에서 위협 종류(열린 4, 막힌 3 ...)를 찾는다
+enum
+{
+    PAT_NONE, PAT_ONE, PAT_TWO, PAT_OPEN_TWO, PAT_THREE, PAT_OPEN_THREE,
+    PAT_FOUR, PAT_OPEN_FOUR, PAT_FIVE, PAT_COUNT
+};
+
+static const int patternScore[PAT_COUNT] = { 0, 1, 8, 40, 60, 500, 600, 5000, 100000 };
+
+#define MAX_WINDOW 6            //winLength + 1
+static unsigned char patternClass[729];     //3^MAX_WINDOW
+static short ternary[1 << MAX_WINDOW];      //비트마스크 → 3진수 (각 비트를 1로)
+static int patternLength;                   //patternClass 를 만든 winLength (0: 아직 안 만듦)
+
+//창 하나의 위협 종류: mine/theirs 는 창 안 비트 (보드 밖은 theirs 에 포함)
+//winLength 칸 부분 창에 상대 돌이 없으면 내 돌 수로 막힌 위협,
+//양 끝이 비고 안쪽 (winLength - 1)칸에 상대 돌이 없으면 내 돌 수로 열린 위협
+static int classifyWindow(int mine, int theirs)
+{
+    int k = winLength, best = PAT_NONE;
+    int full = (1 << k) - 1;
+    for (int s = 0; s < 2; s++)
+    {
+        int sub = full << s;
+        if (theirs & sub) continue;
+        int c = __builtin_popcount(mine & sub), cls = PAT_NONE;
+        if (c == k) cls = PAT_FIVE;
+        else if (c == k - 1) cls = PAT_FOUR;
+        else if (c == k - 2) cls = PAT_THREE;
+        else if (c == k - 3) cls = PAT_TWO;
+        else if (c >= 1) cls = PAT_ONE;
+        if (cls > best) best = cls;
+    }
+
+    int ends = 1 | 1 << k, inner = full & ~1;
+    if (!((mine | theirs) & ends) && !(theirs & inner))
+    {
+        int c = __builtin_popcount(mine & inner), cls = PAT_NONE;
+        if (c == k - 1) cls = PAT_OPEN_FOUR;
+        else if (c == k - 2 && c >= 1) cls = PAT_OPEN_THREE;
+        else if (c == k - 3 && c >= 1) cls = PAT_OPEN_TWO;
+        if (cls > best) best = cls;
+    }
+    return best;
+}
+
+//패턴 표 만들기 (winLength 가 정해진 뒤)
+static void initPatterns(void)
+{
+    int width = winLength + 1;
+    for (int m = 0; m < (1 << MAX_WINDOW); m++)
+    {
+        ternary[m] = 0;
+        for (int i = MAX_WINDOW - 1; i >= 0; i--)
+            ternary[m] = (short)(ternary[m] * 3 + (m >> i & 1));
+    }
+    for (int mine = 0; mine < (1 << width); mine++)
+        for (int theirs = 0; theirs < (1 << width); theirs++)
+            if (!(mine & theirs))
+                patternClass[ternary[mine] + 2 * ternary[theirs]] = (unsigned char)classifyWindow(mine, theirs);
+}
+
+//라인 하나(보드 위 칸은 비트 lo ~ hi)에서 비트 pos 를 덮는 창들의 점수 합 (X 입장)
+//pos < 0 이면 라인 전체. 창은 양 끝에서 보드 밖 한 칸까지 걸칠 수 있다
+static int windowsScore(unsigned int xs, unsigned int os, int lo, int hi, int pos)
+{
+    int width = winLength + 1, mask = (1 << width) - 1;
+    //한 칸씩 밀어 비트 0 을 "보드 밖 왼쪽 한 칸"으로 쓴다
+    unsigned long long inside = ((1ull << (hi - lo + 1)) - 1) << (lo + 1);
+    unsigned long long x = (unsigned long long)xs << 1, o = (unsigned long long)os << 1, wall = ~inside;
+
+    int first = lo, last = hi + 3 - width;
+    if (pos >= 0)
+    {
+        if (first < pos + 2 - width) first = pos + 2 - width;
+        if (last > pos + 1) last = pos + 1;
+    }
+
+    int score = 0;
+    for (int s = first; s <= last; s++)
+    {
+        int xw = (int)(x >> s) & mask, ow = (int)(o >> s) & mask, ww = (int)(wall >> s) & mask;
+        score += patternScore[patternClass[ternary[xw] + 2 * ternary[ow | ww]]];
+        score -= patternScore[patternClass[ternary[ow] + 2 * ternary[xw | ww]]];
+    }
+    return score;
+}
+
+//(x, y)를 지나는 네 라인에서 (x, y)를 덮는 창들의 점수 합
+static inline __attribute__((always_inline))
+int scoreAroundSized(int size, const Board *b, int x, int y)
+{
+    const LineBits *xs = &b->lineBits[0], *os = &b->lineBits[1];
+    int off = x - y, d = off + MAX_SIZE - 1, e = x + y;
+    int dLo = off > 0 ? off : 0, dHi = off < 0 ? size - 1 + off : size - 1;
+    int eLo = e - size + 1 > 0 ? e - size + 1 : 0, eHi = e < size - 1 ? e : size - 1;
+    return windowsScore(xs->rows[x], os->rows[x], 0, size - 1, y)
+         + windowsScore(xs->cols[y], os->cols[y], 0, size - 1, x)
+         + windowsScore(xs->diag[d], os->diag[d], dLo, dHi, x)
+         + windowsScore(xs->anti[e], os->anti[e], eLo, eHi, x);
+}
+
+static inline int scoreAround(const Board *b, int x, int y)
+{
+    return SIZE_DISPATCH(b->size, scoreAroundSized, b, x, y);
+}
+
+//기준 구현: 모든 라인을 처음부터 다시 센 점수 (X 입장, 증분 합계 검증용)
+int evaluateBoardFull(const Board *b)
+{
+    const LineBits *xs = &b->lineBits[0], *os = &b->lineBits[1];
+    int SIZE = b->size, score = 0;
+    for (int i = 0; i < SIZE; i++)
+    {
+        score += windowsScore(xs->rows[i], os->rows[i], 0, SIZE - 1, -1);
+        score += windowsScore(xs->cols[i], os->cols[i], 0, SIZE - 1, -1);
+    }
+    for (int off = 1 - SIZE; off <= SIZE - 1; off++)
+    {
+        int d = off + MAX_SIZE - 1;
+        int lo = off > 0 ? off : 0, hi = off < 0 ? SIZE - 1 + off : SIZE - 1;
+        score += windowsScore(xs->diag[d], os->diag[d], lo, hi, -1);
+    }
+    for (int e = 0; e < 2 * SIZE - 1; e++)
+    {
+        int lo = e - SIZE + 1 > 0 ? e - SIZE + 1 : 0;
+        int hi = e < SIZE - 1 ? e : SIZE - 1;
+        score += windowsScore(xs->anti[e], os->anti[e], lo, hi, -1);
+    }
+    return score;
+}
+
+//보드 초기화 (새 게임마다): 둘레는 벽, 안쪽은 빈 칸
+void initBoard(Board *b, int size)
+{
+    memset(b, 0, sizeof(*b));
+    memset(b->cells, WALL, sizeof(b->cells));
+    for (int x = 0; x < size; x++)
+        for (int y = 0; y < size; y++)
+            b->cells[POS(x, y)] = EMPTY;
+
+    b->size = size;
+    winLength = size < 5 ? size : 5;
+    b->zobristKey = zobristSize[size];
+    if (patternLength != winLength)     //기보를 빠르게 되풀이할 때 판마다 표를 다시 만들지 않는다
+    {
+        initPatterns();
+        patternLength = winLength;
+    }
+    b->evalTotal = evaluateBoardFull(b);
+}
+
+//m 안에 pos 비트를 포함하는 winLength 개 연속 1이 있는지 (시프트와 AND 몇 번)
+static inline int hasRun(unsigned int m, int pos)
+{
+    unsigned int run = m;
+    for (int i = 1; i < winLength; i++)
+        run &= m >> i;              //run 의 비트 i = i 부터 winLength 칸이 모두 돌
+
+    int first = pos - winLength + 1;
+    unsigned int window = (1u << winLength) - 1;
+    window = first >= 0 ? window << first : window >> -first;
+    return (run & window) != 0;
+}
+
+//pos 에 방금 둔 돌로 이겼으면 1, 보드가 가득 차 무승부면 2, 아니면 0
+//pos 를 지나는 네 라인만 본다
+static inline int winAt(const Board *b, int pos)
+{
+    int x = POS_X(pos), y = POS_Y(pos);
+    const LineBits *lb = &b->lineBits[b->cells[pos] == 'O'];
+    if (hasRun(lb->rows[x], y) || hasRun(lb->cols[y], x) ||
+        hasRun(lb->diag[x - y + MAX_SIZE - 1], x) || hasRun(lb->anti[x + y], x))
+        return 1;
+
+    if (b->stoneCount == b->size * b->size) return 2;
+    return 0;
+}
+
+//빈 칸 pos 에 돌 두기 (검사 없음, 탐색용)
+static inline void putStone(Board *b, int pos, char current)
+{
+    int x = POS_X(pos), y = POS_Y(pos);
+    b->cells[pos] = current;
+    b->evalTotal -= scoreAround(b, x, y);   //바뀌는 창은 (x, y)를 덮는 것뿐
+    LineBits *lb = &b->lineBits[current == 'O'];
+    lb->rows[x] |= 1u << y;
+    lb->cols[y] |= 1u << x;
+    lb->diag[x - y + MAX_SIZE - 1] |= 1u << x;
+    lb->anti[x + y] |= 1u << x;
+    b->zobristKey ^= zobristStone[current == 'O'][pos];
+    b->evalTotal += scoreAround(b, x, y);
+    b->stoneCount++;
+}
+
+//pos 의 돌 걷기 (putStone 되돌리기)
+static inline void takeStone(Board *b, int pos)
+{
+    int x = POS_X(pos), y = POS_Y(pos);
+    LineBits *lb = &b->lineBits[b->cells[pos] == 'O'];
+    b->evalTotal -= scoreAround(b, x, y);
+    lb->rows[x] &= ~(1u << y);
+    lb->cols[y] &= ~(1u << x);
+    lb->diag[x - y + MAX_SIZE - 1] &= ~(1u << x);
+    lb->anti[x + y] &= ~(1u << x);
+    b->zobristKey ^= zobristStone[b->cells[pos] == 'O'][pos];
+    b->evalTotal += scoreAround(b, x, y);
+    b->cells[pos] = EMPTY;
+    b->stoneCount--;
+}
+
 //승패 및 무승부 확인 함수
-int checkWin(int SIZE, char board[SIZE][SIZE], int x, int y);
+//(x, y)에 방금 둔 돌로 이겼으면 1, 보드가 가득 차 무승부면 2, 아니면 0
+int checkWin(const Board *b, int x, int y)
+{
+    if (b->cells[POS(x, y)] == EMPTY) return 0;
+    return winAt(b, POS(x, y));
+}
 
 //수 두기 함수
-int placeStone(int SIZE, char board[SIZE][SIZE], int x, int y, char current);
+//범위 밖이거나 이미 돌이 있으면 0, 두었으면 1
+int placeStone(Board *b, int x, int y, char current)
+{
+    if (x < 0 || x >= b->size || y < 0 || y >= b->size || b->cells[POS(x, y)] != EMPTY)
+        return 0;
+    putStone(b, POS(x, y), current);
+    return 1;
+}
+
+//수 무르기 함수
+void removeStone(Board *b, int x, int y)
+{
+    takeStone(b, POS(x, y));
+}
 
 //플레이어 턴 전환 함수
-char switchPlayer(char current);
+char switchPlayer(char current)
+{
+    return current == 'X' ? 'O' : 'X';
+}
 
 
-//메인 함수
-int main(void)
+// ───────── 컴퓨터 (반복 심화 PVS) ─────────
+
+#define WIN_SCORE 1000000       //승리 점수 (평가 합보다 항상 크다)
+#define INF_SCORE 2000000
+#define NEAR_DIST 2             //후보 수: 돌에서 이 거리 안의 빈 칸만
+#define MAX_MOVES (MAX_SIZE * MAX_SIZE)
+
+static long aiNodes;            //탐색 노드 수
+static double aiDeadline;       //이 시각(ms)을 넘기면 탐색 중단
+static int aiAborted;
+static int aiStop;              //다른 스레드가 세우면 돌고 있는 탐색을 멈춘다 (생각 미리 하기 중단)
+
+static double nowMs(void)
 {
-    int SIZE = 0;
-    char buffer[100];
-    while (1)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static int aiStopRequested(void)
+{
+    return __atomic_load_n(&aiStop, __ATOMIC_RELAXED);
+}
+
+//전치표: 64바이트(캐시 라인) 버킷 하나에 항목 4개, 메모리 예산(MB)으로 버킷 수를 정한다
+//같은 키가 없으면 버킷에서 "이전 탐색의 항목 → 얕은 깊이" 순서로 밀어낸다 (깊이 우선 교체)
+enum { TT_EXACT = 1, TT_LOWER, TT_UPPER };
+
+typedef struct
+{
+    unsigned long long key;
+    int score;
+    short move;                 //최선 수 칸 번호 (없으면 -1)
+    signed char depth;          //남은 탐색 깊이
+    unsigned char flag;         //하위 2비트 종류, 상위 6비트 세대(탐색 번호)
+} TTEntry;
+
+#define TT_WAYS 4
+
+typedef struct
+{
+    TTEntry entry[TT_WAYS];
+} __attribute__((aligned(64))) TTBucket;
+
+static TTBucket *ttTable;
+static unsigned long long ttMask;       //버킷 수 - 1
+static unsigned char ttGeneration;
+static long ttHits, ttProbes;
+
+//전치표 할당: 예산 안의 가장 큰 2의 거듭제곱 버킷 수, 실패하면 0
+int initTT(int megabytes)
+{
+    unsigned long long buckets = 1;
+    while (buckets * 2 * sizeof(TTBucket) <= (unsigned long long)megabytes << 20)
+        buckets *= 2;
+
+    free(ttTable);
+    ttTable = aligned_alloc(64, buckets * sizeof(TTBucket));
+    if (!ttTable) return 0;
+    memset(ttTable, 0, buckets * sizeof(TTBucket));
+    ttMask = buckets - 1;
+    return 1;
+}
+
+//승패 점수는 루트로부터의 수가 섞여 있으므로 노드 기준으로 바꿔 저장한다
+static inline int scoreToTT(int score, int ply)
+{
+    if (score >= WIN_SCORE - MAX_MOVES) return score + ply;
+    if (score <= MAX_MOVES - WIN_SCORE) return score - ply;
+    return score;
+}
+
+static inline int scoreFromTT(int score, int ply)
+{
+    if (score >= WIN_SCORE - MAX_MOVES) return score - ply;
+    if (score <= MAX_MOVES - WIN_SCORE) return score + ply;
+    return score;
+}
+
+static inline TTEntry *ttProbe(unsigned long long key)
+{
+    TTBucket *b = &ttTable[key & ttMask];
+    ttProbes++;
+    for (int i = 0; i < TT_WAYS; i++)
+        if (b->entry[i].flag && b->entry[i].key == key)
+        {
+            ttHits++;
+            return &b->entry[i];
+        }
+    return NULL;
+}
+
+static inline void ttStore(unsigned long long key, int score, int move, int depth, int flag)
+{
+    TTBucket *b = &ttTable[key & ttMask];
+    TTEntry *victim = &b->entry[0];
+    for (int i = 0; i < TT_WAYS; i++)
+    {
+        TTEntry *e = &b->entry[i];
+        if (!e->flag || e->key == key)
+        {
+            victim = e;
+            break;
+        }
+        int eOld = (e->flag >> 2) != ttGeneration, vOld = (victim->flag >> 2) != ttGeneration;
+        if (eOld > vOld || (eOld == vOld && e->depth < victim->depth))
+            victim = e;
+    }
+    //같은 국면의 더 깊은 결과를 얕은 결과로 덮지 않는다 (최선 수만 갱신)
+    if (victim->flag && victim->key == key && victim->depth > depth
+        && (victim->flag >> 2) == ttGeneration)
     {
-        printf("보드 크기 입력 (3~19): ");
-        fgets(buffer, sizeof(buffer), stdin);
-        sscanf(buffer, "%d", &SIZE);
-        if (SIZE >=3 && SIZE <= 19) break;
-        else printf("범위에 맞는 수를 입력하세요 (3~19)\n");
+        if (move >= 0) victim->move = (short)move;
+        return;
     }
+    victim->key = key;
+    victim->score = score;
+    victim->move = (short)move;
+    victim->depth = (signed char)depth;
+    victim->flag = (unsigned char)(flag | ttGeneration << 2);
+}
 
-    char board[SIZE][SIZE];
-    for (int i=0; i<SIZE; i++)
-        for (int j=0; j<SIZE; j++)
-            board[i][j] = ' ';
+//평가 함수: me 입장의 점수 (placeStone/removeStone 이 들고 다니는 합계를 읽기만 한다)
+int evaluateBoard(const Board *b, char me)
+{
+    return me == 'X' ? b->evalTotal : -b->evalTotal;
+}
+
+//돌에서 dist 칸 안의 빈 칸을 moves 에 칸 번호로 채운다 (행 비트마스크를 번지게 해서 구한다)
+//행 점유 마스크를 위아래로 dist 줄씩 0 으로 덧대 두어 경계 검사가 없다
+static inline __attribute__((always_inline))
+int nearCellsSized(int size, const Board *b, int dist, int moves[])
+{
+    unsigned int occ[MAX_SIZE + 2 * NEAR_DIST] = { 0 };
+    for (int x = 0; x < size; x++)
+        occ[x + NEAR_DIST] = b->lineBits[0].rows[x] | b->lineBits[1].rows[x];
+
+    unsigned int rowMask = (1u << size) - 1;
+    int n = 0;
+    for (int x = 0; x < size; x++)
+    {
+        unsigned int near = 0;
+        for (int dx = -dist; dx <= dist; dx++)
+        {
+            unsigned int o = occ[x + NEAR_DIST + dx];
+            for (int d = 0; d <= dist; d++)
+                near |= o << d | o >> d;
+        }
+        near &= rowMask & ~occ[x + NEAR_DIST];
+        for (; near; near &= near - 1)
+            moves[n++] = POS(x, __builtin_ctz(near));
+    }
+    return n;
+}
+
+//후보 수: 돌에서 NEAR_DIST 칸 안의 빈 칸, 돌이 없으면 중앙 한 칸
+static int generateCandidates(const Board *b, int moves[])
+{
+    if (b->stoneCount == 0)
+    {
+        moves[0] = POS(b->size / 2, b->size / 2);
+        return 1;
+    }
+    return SIZE_DISPATCH(b->size, nearCellsSized, b, NEAR_DIST, moves);
+}
+
+//m 에서 비트 pos 를 지나는 연속 1의 길이 (pos 자신 포함, pos 는 비어 있어도 1로 친다)
+static inline int runThrough(unsigned int m, int pos)
+{
+    int above = __builtin_ctz(~(m >> (pos + 1)));
+    int below = pos ? __builtin_clz(~(m << (32 - pos))) : 0;
+    return 1 + above + below;
+}
+
+//위협 점수: pos 에 두면 생기는 내 연속 돌과, 막게 되는 상대 연속 돌의 길이로 매긴다
+//이기는 수 → 상대 5목 막기 → 내 4 → 상대 4 막기 ... 순서가 되도록 가중치를 준다
+static int moveThreat(const Board *b, int pos, char me)
+{
+    static const int runWeight[6] = { 0, 0, 4, 64, 1024, 65536 };
+    int x = POS_X(pos), y = POS_Y(pos);
+    int score = 0;
+    for (int p = 0; p < 2; p++)
+    {
+        const LineBits *lb = &b->lineBits[p];
+        int runs[4] = {
+            runThrough(lb->rows[x], y), runThrough(lb->cols[y], x),
+            runThrough(lb->diag[x - y + MAX_SIZE - 1], x), runThrough(lb->anti[x + y], x),
+        };
+        int mine = (p == (me == 'O'));
+        for (int d = 0; d < 4; d++)
+        {
+            int k = runs[d] + 5 - winLength;
+            int w = runWeight[k > 5 ? 5 : k];
+            score += mine ? w * 2 : w;      //같은 길이면 내 공격이 먼저
+        }
+    }
+    return score;
+}
+
+//후보를 위협 점수가 높은 순서로 정렬 (first 가 있으면 맨 앞으로)
+static void orderCandidates(const Board *b, int moves[], int n, char me, int first)
+{
+    int keys[MAX_MOVES];
+    for (int i = 0; i < n; i++)
+    {
+        int move = moves[i];
+        int key = move == first ? INF_SCORE : moveThreat(b, move, me);
+        int j = i;
+        while (j > 0 && keys[j - 1] < key)
+        {
+            keys[j] = keys[j - 1];
+            moves[j] = moves[j - 1];
+            j--;
+        }
+        keys[j] = key;
+        moves[j] = move;
+    }
+}
+
+//PVS (negamax 형태): me 차례에서 me 입장의 점수
+//첫 수는 전체 창, 나머지는 널 창으로 "더 좋은지"만 확인하고 그렇다면 다시 읽는다
+static int pvs(Board *b, int depth, int ply, int alpha, int beta, char me)
+{
+    aiNodes++;
+    if ((aiNodes & 1023) == 0 && (aiStopRequested() || (aiDeadline > 0 && nowMs() >= aiDeadline)))
+        aiAborted = 1;
+    if (aiAborted) return 0;
+
+    if (depth == 0) return evaluateBoard(b, me);
+
+    //🗂️ 전치표: 깊이가 충분하면 값을 쓰고, 모자라도 최선 수는 먼저 읽는다
+    int alphaOrig = alpha, ttMove = -1;
+    unsigned long long key = b->zobristKey;
+    TTEntry *entry = ttProbe(key);
+    if (entry)
+    {
+        ttMove = entry->move;
+        if (entry->depth >= depth)
+        {
+            int value = scoreFromTT(entry->score, ply);
+            int flag = entry->flag & 3;
+            if (flag == TT_EXACT) return value;
+            if (flag == TT_LOWER && value >= beta) return value;
+            if (flag == TT_UPPER && value <= alpha) return value;
+        }
+    }
+
+    int moves[MAX_MOVES];
+    int n = generateCandidates(b, moves);
+    if (n == 0) return 0;   //둘 곳이 없으면 무승부
+    orderCandidates(b, moves, n, me, ttMove);
+
+    int best = -INF_SCORE, bestMove = -1;
+    for (int i = 0; i < n; i++)
+    {
+        putStone(b, moves[i], me);
+        int result = winAt(b, moves[i]), score;
+        if (result == 1) score = WIN_SCORE - ply - 1;
+        else if (result == 2) score = 0;
+        else if (i == 0) score = -pvs(b, depth - 1, ply + 1, -beta, -alpha, switchPlayer(me));
+        else
+        {
+            score = -pvs(b, depth - 1, ply + 1, -alpha - 1, -alpha, switchPlayer(me));
+            if (score > alpha && score < beta)
+                score = -pvs(b, depth - 1, ply + 1, -beta, -alpha, switchPlayer(me));
+        }
+        takeStone(b, moves[i]);
+        if (aiAborted) return 0;
+
+        if (score > best)
+        {
+            best = score;
+            bestMove = moves[i];
+        }
+        if (best > alpha) alpha = best;
+        if (alpha >= beta) break;   //✂️ 가지치기
+    }
+
+    int flag = best <= alphaOrig ? TT_UPPER : best >= beta ? TT_LOWER : TT_EXACT;
+    ttStore(key, scoreToTT(best, ply), bestMove, depth, flag);
+    return best;
+}
+
+//allowed 가 있으면 거기 1 로 표시된 수만 남긴다 (위협 해결기가 막는 수로 좁힐 때)
+static int keepAllowed(int moves[], int n, const unsigned char *allowed)
+{
+    if (!allowed) return n;
+    int kept = 0;
+    for (int i = 0; i < n; i++)
+        if (allowed[moves[i]])
+            moves[kept++] = moves[i];
+    return kept ? kept : n;
+}
+
+//루트 한 번: depth 수까지 읽어 최선 수(칸 번호)와 점수
+static int searchRoot(Board *b, int depth, char me, int first, const unsigned char *allowed, int *scoreOut)
+{
+    int moves[MAX_MOVES];
+    int n = keepAllowed(moves, generateCandidates(b, moves), allowed);
+    orderCandidates(b, moves, n, me, first);
+
+    int alpha = -INF_SCORE, bestMove = moves[0];
+    for (int i = 0; i < n; i++)
+    {
+        putStone(b, moves[i], me);
+        int result = winAt(b, moves[i]), score;
+        if (result == 1) score = WIN_SCORE - 1;
+        else if (result == 2) score = 0;
+        else if (i == 0) score = -pvs(b, depth - 1, 1, -INF_SCORE, -alpha, switchPlayer(me));
+        else
+        {
+            score = -pvs(b, depth - 1, 1, -alpha - 1, -alpha, switchPlayer(me));
+            if (score > alpha)
+                score = -pvs(b, depth - 1, 1, -INF_SCORE, -alpha, switchPlayer(me));
+        }
+        takeStone(b, moves[i]);
+        if (aiAborted) break;
+
+        if (score > alpha)
+        {
+            alpha = score;
+            bestMove = moves[i];
+        }
+    }
+    *scoreOut = alpha;
+    return bestMove;
+}
+
+//컴퓨터 수 찾기: 깊이를 1수씩 늘리며 시간 예산(ms) 안에 끝난 가장 깊은 탐색의 수 (칸 번호)
+//이전 반복의 최선 수를 먼저 읽어 가지치기를 돕는다. allowed 가 있으면 루트에서 그 수들만 본다
+int findBestMove(Board *b, char me, int budgetMs, const unsigned char *allowed, int *depthDone)
+{
+    int maxDepth = b->size * b->size - b->stoneCount;
+    int bestMove = -1, completed = 0;
+
+    aiNodes = ttHits = ttProbes = 0;
+    aiAborted = 0;
+    ttGeneration = (ttGeneration + 1) & 63;
+    aiDeadline = budgetMs > 0 ? nowMs() + budgetMs : 0;
+    for (int depth = 1; depth <= maxDepth; depth++)
+    {
+        int score;
+        int move = searchRoot(b, depth, me, bestMove, allowed, &score);
+        if (aiAborted) break;
+        bestMove = move;
+        completed = depth;
+        if (score >= WIN_SCORE - MAX_MOVES || score <= MAX_MOVES - WIN_SCORE)
+            break;                  //승패가 확정되면 더 읽을 필요 없음
+    }
+    aiDeadline = 0;
+    aiAborted = 0;
+
+    if (bestMove < 0)               //깊이 1도 못 마쳤으면 위협 점수가 가장 높은 수
+    {
+        int moves[MAX_MOVES];
+        int n = keepAllowed(moves, generateCandidates(b, moves), allowed);
+        orderCandidates(b, moves, n, me, -1);
+        bestMove = moves[0];
+    }
+    *depthDone = completed;
+    return bestMove;
+}
+
+
+
+// ───────── 위협 해결기 (VCF / VCT) ─────────
+//공격 쪽은 강제 수(VCF: 4만, VCT: 4와 열린 3)만, 수비 쪽은 그 위협을 막는 수만 두는 좁은 트리를
+//증명수 탐색(proof-number search)으로 푼다. 본 탐색이 닿지 못하는 20수 넘는 필승 수순을 빨리 찾는다.
+//트리는 미리 잡아 둔 노드 표에서만 자라고, 표가 차면 "모름"으로 끝난다.
+
+#define THREAT_INF 100000000
+#define THREAT_MAX_DEPTH 40     //이보다 긴 수순은 증명 실패로 본다
+#define THREAT_NODES (1 << 20)  //노드 표 크기 (공용, 해결기 호출마다 처음부터 다시 쓴다)
+#define THREAT_DEFENSE_NODES 20000  //상대 VCF 를 막는 수인지 볼 때 수 하나당 노드 예산
+#define THREAT_TIME_SHARE 4     //한 수 시간 예산 중 위협 검사에 쓰는 몫 (1/4)
+
+enum { THREAT_VCF, THREAT_VCT };
+
+typedef struct
+{
+    int pn, dn;                 //증명수, 반증수 (공격 쪽이 이기는 것을 증명)
+    int parent;
+    int firstChild;             //자식은 표에서 연속으로 잡는다 (-1: 아직 펼치지 않음)
+    short move;                 //이 노드로 오는 수 (칸 번호, 루트는 -1)
+    short childCount;
+} PnNode;
+
+static PnNode *pnPool;
+static int pnUsed, pnLimit;
+
+//방향별 칸 번호 차이: 가로, 세로, ↘, ↙ (둘레가 벽이라 벽을 만날 때까지 그냥 걸어가면 된다)
+static const int direction[4] = { 1, STRIDE, STRIDE + 1, STRIDE - 1 };
+
+//한 라인에서 mine 이 한 칸만 더 두면 length 가 되는 빈 칸들 ([lo, hi] 안의 비트마스크)
+//e 가 창 안의 j 번째일 때 나머지 칸이 모두 mine 인지를 모든 e 에 대해 한꺼번에 시프트-AND 로 본다
+static inline __attribute__((always_inline))
+unsigned int lineFivesSized(int length, unsigned int mine, unsigned int theirs, int lo, int hi)
+{
+    unsigned int fives = 0;
+    for (int j = 0; j < length; j++)
+    {
+        unsigned int all = ~0u;
+        for (int t = -j; t < length - j; t++)
+            if (t) all &= t > 0 ? mine >> t : mine << -t;
+        fives |= all;
+    }
+    return fives & ((2u << hi) - (1u << lo)) & ~(mine | theirs);
+}
+
+//보통은 5목이라 길이를 상수로 넘겨 반복문을 펼친다
+static inline unsigned int lineFives(unsigned int mine, unsigned int theirs, int lo, int hi)
+{
+    return winLength == 5 ? lineFivesSized(5, mine, theirs, lo, hi)
+                          : lineFivesSized(winLength, mine, theirs, lo, hi);
+}
+
+//(x, y)를 지나는 dir 방향 라인 (비트 번호는 가로면 y, 나머지는 x)
+typedef struct
+{
+    unsigned int mine, theirs;
+    int lo, hi, at;
+} LineView;
+
+static LineView lineView(const Board *b, int side, int x, int y, int dir)
+{
+    const LineBits *m = &b->lineBits[side], *t = &b->lineBits[!side];
+    int size = b->size, off = x - y, e = x + y;
+    switch (dir)
+    {
+        case 0: return (LineView){ m->rows[x], t->rows[x], 0, size - 1, y };
+        case 1: return (LineView){ m->cols[y], t->cols[y], 0, size - 1, x };
+        case 2: return (LineView){ m->diag[off + MAX_SIZE - 1], t->diag[off + MAX_SIZE - 1],
+                                   off > 0 ? off : 0, off < 0 ? size - 1 + off : size - 1, x };
+        default: return (LineView){ m->anti[e], t->anti[e],
+                                    e - size + 1 > 0 ? e - size + 1 : 0, e < size - 1 ? e : size - 1, x };
+    }
+}
+
+//lineView 의 비트 번호 → 칸 번호
+static inline int lineCell(int x, int y, int dir, int bit)
+{
+    switch (dir)
+    {
+        case 0: return POS(x, bit);
+        case 1: return POS(bit, y);
+        case 2: return POS(bit, bit - (x - y));
+        default: return POS(bit, x + y - bit);
+    }
+}
+
+//side 가 한 수로 winLength 를 만드는 칸 (서로 다른 칸을 최대 max 개까지 out 에, 개수를 돌려준다)
+//라인 단위로 본다: 가로·세로 size 줄, 대각선 두 방향 2 * size - 1 줄
+static int fivePoints(const Board *b, int side, int out[], int max)
+{
+    int n = 0, size = b->size;
+    for (int dir = 0; dir < 4; dir++)
+        for (int line = 0; line < (dir < 2 ? size : 2 * size - 1); line++)
+        {
+            //라인 위의 한 칸 (x, y)
+            int x = dir == 1 ? 0 : line, y = dir == 1 ? line : 0;
+            if (dir == 2 && line >= size) x = 0, y = line - size + 1;
+            if (dir == 3 && line >= size) x = size - 1, y = line - size + 1;
+
+            LineView v = lineView(b, side, x, y, dir);
+            for (unsigned int m = lineFives(v.mine, v.theirs, v.lo, v.hi); m; m &= m - 1)
+            {
+                int pos = lineCell(x, y, dir, __builtin_ctz(m)), dup = 0;
+                for (int i = 0; i < n; i++)
+                    dup |= out[i] == pos;
+                if (dup) continue;
+                out[n++] = pos;
+                if (n == max) return n;
+            }
+        }
+    return n;
+}
 
-    printBoard(SIZE, board);
+//side 가 빈 칸 pos 에 두면 생기는 위협: 2 = 4(다음 수에 winLength), 1 = 열린 3(다음 수에 열린 4), 0 = 없음
+static int threatAt(const Board *b, int side, int pos, int wantThree)
+{
+    int x = POS_X(pos), y = POS_Y(pos), three = 0;
+    for (int dir = 0; dir < 4; dir++)
+    {
+        LineView v = lineView(b, side, x, y, dir);
+        unsigned int mine = v.mine | 1u << v.at;
+        int from = v.at - winLength + 1, to = v.at + winLength - 1;
+        unsigned int reach = (2u << (to < v.hi ? to : v.hi)) - (1u << (from > v.lo ? from : v.lo));
+        if (__builtin_popcount(mine & reach) < winLength - 2) continue;    //3 도 못 되는 라인
+        if (lineFives(mine, v.theirs, v.lo, v.hi)) return 2;
+        if (!wantThree || three) continue;
+
+        //같은 라인에서 한 수 더 두면 승리 칸이 둘 생기는가 (열린 4)
+        int lo = v.at - winLength > v.lo ? v.at - winLength : v.lo;
+        int hi = v.at + winLength < v.hi ? v.at + winLength : v.hi;
+        for (int e = lo; e <= hi && !three; e++)
+            if (!((mine | v.theirs) >> e & 1) &&
+                __builtin_popcount(lineFives(mine | 1u << e, v.theirs, v.lo, v.hi)) >= 2)
+                three = 1;
+    }
+    return three;
+}
+
+//공격 쪽 강제 수 (4, VCT 면 열린 3 도)
+static int forcingMoves(const Board *b, int side, int mode, int moves[])
+{
+    int cand[MAX_MOVES], n = 0;
+    int count = b->stoneCount ? SIZE_DISPATCH(b->size, nearCellsSized, b, NEAR_DIST, cand) : 0;
+    for (int i = 0; i < count; i++)
+        if (threatAt(b, side, cand[i], mode == THREAT_VCT))
+            moves[n++] = cand[i];
+    return n;
+}
 
+//열린 3 을 막는 수: 3 을 만든 수를 지나는 네 라인에서 winLength 칸 안의 빈 칸, 그리고 수비 쪽의 4
+static int threeDefenses(const Board *b, int defender, int last, int moves[])
+{
+    static _Thread_local unsigned char seen[BOARD_CELLS];
+    int n = 0;
+    for (int dir = 0; dir < 4; dir++)
+        for (int s = -1; s <= 1; s += 2)
+        {
+            int pos = last;
+            for (int step = 0; step < winLength; step++)
+            {
+                pos += s * direction[dir];
+                if (b->cells[pos] == WALL) break;
+                if (b->cells[pos] == EMPTY && !seen[pos])
+                {
+                    seen[pos] = 1;
+                    moves[n++] = pos;
+                }
+            }
+        }
+
+    int cand[MAX_MOVES];
+    int count = SIZE_DISPATCH(b->size, nearCellsSized, b, NEAR_DIST, cand);
+    for (int i = 0; i < count; i++)
+        if (!seen[cand[i]] && threatAt(b, defender, cand[i], 0) == 2)
+        {
+            seen[cand[i]] = 1;
+            moves[n++] = cand[i];
+        }
+    for (int i = 0; i < n; i++)
+        seen[moves[i]] = 0;
+    return n;
+}
+
+//해결기용 가벼운 두기/걷기: 칸과 비트보드만 고친다 (평가 합계와 Zobrist 키는 쓰지 않으니 그대로 둔다)
+static inline void flipStone(Board *b, int pos, char current)
+{
+    int x = POS_X(pos), y = POS_Y(pos);
+    LineBits *lb = &b->lineBits[current == 'O'];
+    lb->rows[x] ^= 1u << y;
+    lb->cols[y] ^= 1u << x;
+    lb->diag[x - y + MAX_SIZE - 1] ^= 1u << x;
+    lb->anti[x + y] ^= 1u << x;
+    if (b->cells[pos] == EMPTY)
+    {
+        b->cells[pos] = current;
+        b->stoneCount++;
+    }
+    else
+    {
+        b->cells[pos] = EMPTY;
+        b->stoneCount--;
+    }
+}
+
+static inline int pnAdd(int a, int b)
+{
+    return a + b >= THREAT_INF ? THREAT_INF : a + b;
+}
+
+//노드 펼치기: 자식을 만들거나 (승/패가 정해지면) pn, dn 을 0 / 무한으로
+//orNode: 공격 쪽 차례인 노드, depth: 루트에서 몇 수째인지
+static void pnExpand(const Board *b, int index, int orNode, int attacker, int mode, int depth)
+{
+    PnNode *node = &pnPool[index];
+    int defender = !attacker, fives[3], moves[MAX_MOVES], n = 0;
+    node->firstChild = pnUsed;
+    node->childCount = 0;
+
+    if (orNode)
+    {
+        if (fivePoints(b, attacker, fives, 1))
+        {
+            node->pn = 0, node->dn = THREAT_INF;
+            return;
+        }
+        int threats = fivePoints(b, defender, fives, 2);
+        if (threats < 2 && depth < THREAT_MAX_DEPTH)
+        {
+            if (threats == 1)       //상대 4 를 막는 수가 강제 수일 때만 이어 간다
+            {
+                if (threatAt(b, attacker, fives[0], mode == THREAT_VCT))
+                    moves[n++] = fives[0];
+            }
+            else n = forcingMoves(b, attacker, mode, moves);
+        }
+    }
+    else
+    {
+        if (fivePoints(b, defender, fives, 1))
+        {
+            node->pn = THREAT_INF, node->dn = 0;
+            return;
+        }
+        int threats = fivePoints(b, attacker, fives, 2);
+        if (threats >= 2)
+        {
+            node->pn = 0, node->dn = THREAT_INF;
+            return;
+        }
+        if (threats == 1) moves[n++] = fives[0];
+        else n = threeDefenses(b, defender, node->move, moves);
+        if (n == 0)
+        {
+            node->pn = 0, node->dn = THREAT_INF;
+            return;
+        }
+    }
+
+    if (n == 0 || pnUsed + n > pnLimit)
+    {
+        //강제 수가 없으면 반증, 표가 차면 더 펼칠 수 없으니 이 노드도 반증으로 둔다
+        node->pn = THREAT_INF, node->dn = 0;
+        return;
+    }
+    for (int i = 0; i < n; i++)
+        pnPool[pnUsed + i] = (PnNode){ 1, 1, index, -1, (short)moves[i], 0 };
+    pnUsed += n;
+    node->childCount = (short)n;
+    node->pn = orNode ? 1 : n;
+    node->dn = orNode ? n : 1;
+}
+
+//자식 값으로 pn, dn 다시 계산
+static void pnUpdate(PnNode *node, int orNode)
+{
+    int pn = orNode ? THREAT_INF : 0, dn = orNode ? 0 : THREAT_INF;
+    for (int i = 0; i < node->childCount; i++)
+    {
+        const PnNode *c = &pnPool[node->firstChild + i];
+        if (orNode)
+        {
+            if (c->pn < pn) pn = c->pn;
+            dn = pnAdd(dn, c->dn);
+        }
+        else
+        {
+            pn = pnAdd(pn, c->pn);
+            if (c->dn < dn) dn = c->dn;
+        }
+    }
+    node->pn = pn;
+    node->dn = dn;
+}
+
+static long threatNodes;        //마지막 해결기 호출들이 쓴 노드 수 (출력용)
+
+//attacker 가 먼저 두어 강제 수만으로 이길 수 있으면 첫 수 (칸 번호), 증명하지 못하면 -1
+//노드 maxNodes 개를 쓰거나 deadline(ms, 0 이면 없음)을 넘기면 증명 못 한 것으로 끝낸다
+//b 는 탐색 중에 고쳤다가 되돌려 놓는다
+int solveThreats(Board *b, char attacker, int mode, int maxNodes, double deadline)
+{
+    if (!pnPool)
+    {
+        pnPool = malloc(THREAT_NODES * sizeof(PnNode));
+        if (!pnPool) return -1;
+    }
+    int side = attacker == 'O', path[THREAT_MAX_DEPTH + 2];
+    pnLimit = maxNodes < THREAT_NODES ? maxNodes : THREAT_NODES;
+    pnUsed = 1;
+    pnPool[0] = (PnNode){ 1, 1, -1, -1, -1, 0 };
+    pnExpand(b, 0, 1, side, mode, 0);
+
+    for (int iter = 1; pnPool[0].pn != 0 && pnPool[0].dn != 0; iter++)
+    {
+        if ((iter & 63) == 0 && (aiStopRequested() || (deadline > 0 && nowMs() > deadline))) return -1;
+
+        //가장 증명에 가까운 잎까지 내려가기 (OR: pn 최소, AND: dn 최소)
+        int index = 0, depth = 0;
+        while (pnPool[index].childCount > 0)
+        {
+            const PnNode *node = &pnPool[index];
+            int orNode = !(depth & 1), best = node->firstChild;
+            for (int i = 1; i < node->childCount; i++)
+            {
+                const PnNode *c = &pnPool[node->firstChild + i];
+                if (orNode ? c->pn < pnPool[best].pn : c->dn < pnPool[best].dn)
+                    best = node->firstChild + i;
+            }
+            flipStone(b, pnPool[best].move, (depth & 1) ? switchPlayer(attacker) : attacker);
+            path[depth++] = best;
+            index = best;
+        }
+
+        pnExpand(b, index, !(depth & 1), side, mode, depth);
+        threatNodes += pnPool[index].childCount;
+
+        //올라가며 조상 값 고치기
+        while (depth > 0)
+        {
+            --depth;
+            flipStone(b, pnPool[path[depth]].move, (depth & 1) ? switchPlayer(attacker) : attacker);
+            pnUpdate(&pnPool[pnPool[path[depth]].parent], !(depth & 1));
+        }
+    }
+
+    if (pnPool[0].pn != 0) return -1;
+    for (int i = 0; i < pnPool[0].childCount; i++)
+        if (pnPool[pnPool[0].firstChild + i].pn == 0)
+            return pnPool[pnPool[0].firstChild + i].move;
+    return -1;
+}
+
+//본 탐색 전 위협 검사 (한 수 예산 budgetMs 의 1/THREAT_TIME_SHARE 안에서)
+//내게 VCF(없으면 VCT)가 있으면 그 첫 수를 돌려주고 *kind 에 THREAT_VCF / THREAT_VCT 를 적는다.
+//상대에게 VCF 가 있으면 한 수 둔 뒤 상대 VCF 가 사라지는 수만 allowed 에 1 로 남기고 *restricted 에 그 수 개수를 적는다
+//(막을 수 없으면 제한하지 않고, 시간이 모자라 못 본 수는 남겨 둔다). 둘 다 아니면 -1
+int threatPrecheck(Board *b, char me, int budgetMs, unsigned char allowed[BOARD_CELLS], int *restricted, int *kind)
+{
+    threatNodes = 0;
+    *restricted = 0;
+    if (b->stoneCount < 2 * winLength - 5) return -1;  //돌이 이보다 적으면 3 을 만들 수 없다
+
+    //단계마다 검사 시간의 1/4 씩: 내 VCF, 내 VCT, 상대 VCF, 막는 수 고르기
+    double start = nowMs(), share = budgetMs > 0 ? (double)budgetMs / THREAT_TIME_SHARE / 4 : 0;
+    for (int mode = THREAT_VCF; mode <= THREAT_VCT; mode++)
+    {
+        int move = solveThreats(b, me, mode, THREAT_NODES, share > 0 ? start + share * (mode + 1) : 0);
+        if (move >= 0)
+        {
+            *kind = mode;
+            return move;
+        }
+    }
+
+    char opponent = switchPlayer(me);
+    if (solveThreats(b, opponent, THREAT_VCF, THREAT_NODES, share > 0 ? start + share * 3 : 0) < 0)
+        return -1;
+
+    int moves[MAX_MOVES], n = generateCandidates(b, moves), safe = 0;
+    double deadline = share > 0 ? start + share * 4 : 0;
+    memset(allowed, 0, BOARD_CELLS);
+    for (int i = 0; i < n; i++)
+    {
+        if (deadline > 0 && nowMs() > deadline)
+        {
+            allowed[moves[i]] = 1;      //못 본 수
+            continue;
+        }
+        putStone(b, moves[i], me);
+        if (solveThreats(b, opponent, THREAT_VCF, THREAT_DEFENSE_NODES, deadline) < 0)
+            allowed[moves[i]] = 1;
+        takeStone(b, moves[i]);
+    }
+    for (int i = 0; i < n; i++)
+        safe += allowed[moves[i]];
+    *restricted = safe < n ? safe : 0;
+    return -1;
+}
+
+
+// ───────── 컴퓨터 (병렬 MCTS) ─────────
+//UCT 로 트리를 내려가 잎을 펼치고, 무작위 플레이아웃 결과를 거꾸로 더한다.
+//스레드들이 트리 하나를 같이 쓰며 (tree parallelism), 노드 통계는 원자적 덧셈으로만 고친다.
+//내려가는 중인 경로에는 가상 패배(virtual loss)를 얹어 다른 스레드가 다른 가지를 고르게 한다.
+
+#define MCTS_UCT_C 1.0          //탐험 상수
+#define MCTS_VIRTUAL_LOSS 3     //가상 패배 수
+#define MCTS_ROLLOUT_NEAR 1     //플레이아웃 수는 돌에서 이 거리 안에서 고른다
+
+enum { NODE_LEAF, NODE_EXPANDING, NODE_EXPANDED };
+
+typedef struct
+{
+    int firstChild;             //자식은 노드 풀에서 연속으로 잡는다
+    short move;                 //이 노드로 오는 수 (칸 번호, 루트는 -1)
+    short childCount;
+    int visits;
+    int reward;                 //이 노드의 수를 둔 쪽 기준 (승 2, 무 1, 패 0)의 합
+    int virtualLoss;
+    int state;                  //NODE_LEAF → NODE_EXPANDING → NODE_EXPANDED
+} MctsNode;
+
+//노드 풀: 미리 한 번 잡아 두고 수마다 처음부터 다시 쓴다
+static MctsNode *mctsPool;
+static int mctsCapacity;
+static int mctsUsed;            //원자적으로 늘린다
+
+typedef struct
+{
+    char me;
+    double deadline;
+    const Board *root;          //플레이아웃마다 자기 보드로 복사해서 쓴다
+    unsigned int seed;
+    long playouts;
+    pthread_t thread;
+} MctsWorker;
+
+//노드 풀 할당 (메모리 예산 MB), 실패하면 0
+int initMcts(int megabytes)
+{
+    mctsCapacity = (int)(((long long)megabytes << 20) / sizeof(MctsNode));
+    free(mctsPool);
+    mctsPool = malloc((size_t)mctsCapacity * sizeof(MctsNode));
+    return mctsPool != NULL;
+}
+
+//노드 하나 펼치기: 후보 수를 위협 순으로 자식으로 만든다 (한 스레드만 성공)
+static void expandNode(const Board *b, MctsNode *node, char toMove)
+{
+    int expected = NODE_LEAF;
+    if (!__atomic_compare_exchange_n(&node->state, &expected, NODE_EXPANDING, 0,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+        return;
+
+    int moves[MAX_MOVES];
+    int n = generateCandidates(b, moves);
+    orderCandidates(b, moves, n, toMove, -1);
+
+    int first = __atomic_fetch_add(&mctsUsed, n, __ATOMIC_RELAXED);
+    if (first + n > mctsCapacity)
+    {
+        //풀이 찼으면 잡은 몫을 돌려놓고 잎으로 남긴다 (이후로는 플레이아웃만)
+        __atomic_fetch_sub(&mctsUsed, n, __ATOMIC_RELAXED);
+        __atomic_store_n(&node->state, NODE_LEAF, __ATOMIC_RELEASE);
+        return;
+    }
+    for (int i = 0; i < n; i++)
+    {
+        MctsNode *child = &mctsPool[first + i];
+        child->firstChild = -1;
+        child->move = (short)moves[i];
+        child->childCount = 0;
+        child->visits = child->reward = child->virtualLoss = 0;
+        child->state = NODE_LEAF;
+    }
+    node->firstChild = first;
+    node->childCount = (short)n;
+    __atomic_store_n(&node->state, NODE_EXPANDED, __ATOMIC_RELEASE);
+}
+
+//UCT 로 자식 고르기: 가상 패배를 방문 수와 패배로 함께 센다, 안 가 본 자식이 먼저
+static MctsNode *selectChild(const MctsNode *node)
+{
+    int parentVisits = __atomic_load_n(&node->visits, __ATOMIC_RELAXED);
+    double logParent = log(parentVisits + 1.0);
+    MctsNode *best = &mctsPool[node->firstChild];
+    double bestValue = -1;
+
+    for (int i = 0; i < node->childCount; i++)
+    {
+        MctsNode *child = &mctsPool[node->firstChild + i];
+        int visits = __atomic_load_n(&child->visits, __ATOMIC_RELAXED)
+                   + __atomic_load_n(&child->virtualLoss, __ATOMIC_RELAXED);
+        if (visits == 0) return child;
+        double mean = __atomic_load_n(&child->reward, __ATOMIC_RELAXED) / (2.0 * visits);
+        double value = mean + MCTS_UCT_C * sqrt(logParent / visits);
+        if (value > bestValue)
+        {
+            bestValue = value;
+            best = child;
+        }
+    }
+    return best;
+}
+
+//무작위 플레이아웃: 돌 근처 빈 칸에 번갈아 두며 승자('X', 'O') 또는 무승부(' ')
+//바로 이기는 수가 있으면 그 수를, 상대가 다음 수에 이기면 그 자리를 막는다 (가벼운 편향)
+static char rollout(Board *b, char toMove, unsigned int *seed)
+{
+    while (b->stoneCount < b->size * b->size)
+    {
+        int moves[MAX_MOVES];
+        int n = b->stoneCount ? SIZE_DISPATCH(b->size, nearCellsSized, b, MCTS_ROLLOUT_NEAR, moves)
+                              : generateCandidates(b, moves);   //돌이 없을 때 중앙
+
+        int pick = moves[rand_r(seed) % n], urgent = 0;
+        for (int i = 0; i < n; i++)
+        {
+            int threat = moveThreat(b, moves[i], toMove);
+            if (threat >= 65536 * 2)        //내 5목
+            {
+                pick = moves[i];
+                break;
+            }
+            if (threat >= 65536 && !urgent) //상대 5목 자리
+            {
+                pick = moves[i];
+                urgent = 1;
+            }
+        }
+
+        putStone(b, pick, toMove);
+        if (winAt(b, pick) == 1) return toMove;
+        toMove = switchPlayer(toMove);
+    }
+    return ' ';
+}
+
+//워커: 마감까지 선택 → 펼치기 → 플레이아웃 → 역전파를 반복한다
+static void *mctsWorker(void *arg)
+{
+    MctsWorker *w = arg;
+    Board board;
+    MctsNode *path[MAX_MOVES + 1];
+
+    while (nowMs() < w->deadline)
+    {
+        board = *w->root;       //루트 국면 복원
+
+        //선택: 펼쳐진 노드를 따라 내려가며 가상 패배를 얹는다
+        MctsNode *node = &mctsPool[0];
+        char toMove = w->me, winner = 0;
+        int length = 0;
+        path[length++] = node;
+        while (__atomic_load_n(&node->state, __ATOMIC_ACQUIRE) == NODE_EXPANDED && node->childCount > 0)
+        {
+            node = selectChild(node);
+            __atomic_fetch_add(&node->virtualLoss, MCTS_VIRTUAL_LOSS, __ATOMIC_RELAXED);
+            path[length++] = node;
+
+            putStone(&board, node->move, toMove);
+            int result = winAt(&board, node->move);
+            if (result == 1) winner = toMove;
+            else if (result == 2) winner = ' ';
+            toMove = switchPlayer(toMove);
+            if (winner) break;
+        }
+
+        //펼치기 + 플레이아웃 (끝난 국면이면 그 결과 그대로)
+        if (!winner)
+        {
+            if (__atomic_load_n(&node->visits, __ATOMIC_RELAXED) > 0)
+                expandNode(&board, node, toMove);
+            winner = rollout(&board, toMove, &w->seed);
+        }
+
+        //역전파: 각 노드의 수를 둔 쪽 기준으로 보상
+        char mover = switchPlayer(w->me);   //루트는 상대가 방금 둔 국면
+        for (int i = 0; i < length; i++)
+        {
+            MctsNode *n = path[i];
+            int reward = winner == ' ' ? 1 : winner == mover ? 2 : 0;
+            if (i > 0) __atomic_fetch_sub(&n->virtualLoss, MCTS_VIRTUAL_LOSS, __ATOMIC_RELAXED);
+            __atomic_fetch_add(&n->visits, 1, __ATOMIC_RELAXED);
+            __atomic_fetch_add(&n->reward, reward, __ATOMIC_RELAXED);
+            mover = switchPlayer(mover);
+        }
+        w->playouts++;
+    }
+    return NULL;
+}
+
+//MCTS 로 수 찾기: threads 개 스레드가 budgetMs 동안 트리를 키우고, 가장 많이 방문한 수를 둔다
+//allowed 가 있으면 루트 자식을 그 수들로 좁힌다
+int findBestMoveMcts(const Board *b, char me, int budgetMs, int threads, const unsigned char *allowed,
+                     long *playoutsOut)
+{
+    mctsUsed = 1;
+    MctsNode *rootNode = &mctsPool[0];
+    rootNode->firstChild = -1;
+    rootNode->move = -1;
+    rootNode->childCount = 0;
+    rootNode->visits = rootNode->reward = rootNode->virtualLoss = 0;
+    rootNode->state = NODE_LEAF;
+    expandNode(b, rootNode, me);
+    if (allowed)
+    {
+        MctsNode *children = &mctsPool[rootNode->firstChild];
+        int kept = 0;
+        for (int i = 0; i < rootNode->childCount; i++)
+            if (allowed[children[i].move])
+                children[kept++] = children[i];
+        if (kept) rootNode->childCount = (short)kept;
+    }
+
+    MctsWorker workers[threads];
+    double deadline = nowMs() + budgetMs;
+    for (int t = 0; t < threads; t++)
+    {
+        workers[t] = (MctsWorker){ me, deadline, b, 0x9E3779B9u * (t + 1) ^ (unsigned int)time(NULL), 0, 0 };
+        pthread_create(&workers[t].thread, NULL, mctsWorker, &workers[t]);
+    }
+    long playouts = 0;
+    for (int t = 0; t < threads; t++)
+    {
+        pthread_join(workers[t].thread, NULL);
+        playouts += workers[t].playouts;
+    }
+
+    //워커는 자기 사본만 고치므로 b 는 그대로다
+    int bestMove = -1, bestVisits = -1;
+    for (int i = 0; i < rootNode->childCount; i++)
+    {
+        const MctsNode *child = &mctsPool[rootNode->firstChild + i];
+        if (child->visits > bestVisits)
+        {
+            bestVisits = child->visits;
+            bestMove = child->move;
+        }
+    }
+    *playoutsOut = playouts;
+    return bestMove;
+}
+
+
+// ───────── 기보 (저장 · 불러오기) ─────────
+//파일 = 매직 "GMKREC1\n" 뒤에 기보 레코드를 이어 붙인다 (쓰기는 덧붙이기만, 읽기는 앞에서부터 한 판씩)
+//레코드 = 본문 길이(varint) | 본문 | 체크섬 (본문의 FNV-1a 32비트, 리틀 엔디언 4바이트)
+//본문 = 보드 크기(1) | 결과(1) | 시드(varint) | 수 개수(varint) | 수 ...
+//수 = 0부터 센 칸 번호 x * 크기 + y 를 직전 수(첫 수는 중앙)와의 차이로 (zigzag varint, 가까운 수는 1바이트)
+
+#define RECORD_MAGIC "GMKREC1\n"
+#define RECORD_MAX_BYTES (2 + 10 + 2 + 2 * MAX_MOVES)
+
+enum { RESULT_NONE, RESULT_X, RESULT_O, RESULT_DRAW };
+
+typedef struct
+{
+    int size;
+    int result;                 //RESULT_* (끝나지 않은 판은 RESULT_NONE)
+    unsigned long long seed;    //자가 대국의 무작위 시드 (사람과 둔 판은 시작 시각)
+    int moveCount;
+    short moves[MAX_MOVES];     //0부터 센 x * size + y
+} GameRecord;
+
+static int putVarint(unsigned char *p, unsigned long long v)
+{
+    int n = 0;
+    for (; v >= 0x80; v >>= 7)
+        p[n++] = (unsigned char)(v | 0x80);
+    p[n++] = (unsigned char)v;
+    return n;
+}
+
+//읽은 바이트 수, end 를 넘거나 10바이트를 넘으면 0
+static int getVarint(const unsigned char *p, const unsigned char *end, unsigned long long *v)
+{
+    *v = 0;
+    for (int n = 0; n < 10 && p + n < end; n++)
+    {
+        *v |= (unsigned long long)(p[n] & 0x7F) << (7 * n);
+        if (!(p[n] & 0x80)) return n + 1;
+    }
+    return 0;
+}
+
+static unsigned int fnv1a(const unsigned char *p, size_t n)
+{
+    unsigned int h = 2166136261u;
+    for (size_t i = 0; i < n; i++)
+        h = (h ^ p[i]) * 16777619u;
+    return h;
+}
+
+//결과 칸 x * size + y 로 판의 결과 정하기 (승 / 무 / 진행 중)
+static int recordResult(const Board *b, int cell, char mover)
+{
+    int result = winAt(b, POS(cell / b->size, cell % b->size));
+    if (result == 1) return mover == 'X' ? RESULT_X : RESULT_O;
+    return result == 2 ? RESULT_DRAW : RESULT_NONE;
+}
+
+//기보 파일을 덧붙이기로 열기 (새 파일이면 매직을 쓴다), 실패하면 NULL
+FILE *openRecordWriter(const char *path)
+{
+    FILE *f = fopen(path, "ab");
+    if (!f) return NULL;
+    setvbuf(f, NULL, _IOFBF, 1 << 20);
+    if (ftell(f) == 0 && fwrite(RECORD_MAGIC, 8, 1, f) != 1)
+    {
+        fclose(f);
+        return NULL;
+    }
+    return f;
+}
+
+//한 판 쓰기, 실패하면 0
+int writeRecord(FILE *f, const GameRecord *r)
+{
+    unsigned char body[RECORD_MAX_BYTES], head[10], tail[4];
+    int n = 0, prev = (r->size / 2) * r->size + r->size / 2;
+    body[n++] = (unsigned char)r->size;
+    body[n++] = (unsigned char)r->result;
+    n += putVarint(body + n, r->seed);
+    n += putVarint(body + n, (unsigned long long)r->moveCount);
+    for (int i = 0; i < r->moveCount; i++)
+    {
+        int delta = r->moves[i] - prev;
+        n += putVarint(body + n, delta >= 0 ? 2u * delta : 2u * -delta - 1);
+        prev = r->moves[i];
+    }
+
+    unsigned int sum = fnv1a(body, (size_t)n);
+    for (int i = 0; i < 4; i++)
+        tail[i] = (unsigned char)(sum >> (8 * i));
+    size_t h = (size_t)putVarint(head, (unsigned long long)n);
+    return fwrite(head, 1, h, f) == h && fwrite(body, 1, (size_t)n, f) == (size_t)n &&
+           fwrite(tail, 1, 4, f) == 4;
+}
+
+//기보 파일을 읽기로 열기 (매직 확인), 실패하면 NULL
+FILE *openRecordReader(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    setvbuf(f, NULL, _IOFBF, 1 << 20);
+    char magic[8];
+    if (fread(magic, 8, 1, f) != 1 || memcmp(magic, RECORD_MAGIC, 8) != 0)
+    {
+        fclose(f);
+        return NULL;
+    }
+    return f;
+}
+
+//다음 한 판 읽기: 1 성공, 0 파일 끝,
+//-1 깨진 레코드 (체크섬·내용 오류, 건너뛰고 계속 읽을 수 있다), -2 잘린 파일 (더 읽을 수 없다)
+int readRecord(FILE *f, GameRecord *r)
+{
+    unsigned long long len = 0;
+    int c, shift = 0;
+    do
+    {
+        if ((c = getc(f)) == EOF) return shift ? -2 : 0;
+        len |= (unsigned long long)(c & 0x7F) << shift;
+        shift += 7;
+    } while ((c & 0x80) && shift < 70);
+    if ((c & 0x80) || len < 2 || len > RECORD_MAX_BYTES) return -2;
+
+    unsigned char buf[RECORD_MAX_BYTES + 4];
+    if (fread(buf, 1, len + 4, f) != len + 4) return -2;
+    unsigned int sum = buf[len] | buf[len + 1] << 8 | buf[len + 2] << 16 | (unsigned int)buf[len + 3] << 24;
+    if (sum != fnv1a(buf, len)) return -1;
+
+    r->size = buf[0];
+    r->result = buf[1];
+    if (r->size < 3 || r->size > MAX_SIZE || r->result > RESULT_DRAW) return -1;
+    int cells = r->size * r->size, k;
+    const unsigned char *p = buf + 2, *end = buf + len;
+    unsigned long long v;
+    if (!(k = getVarint(p, end, &r->seed))) return -1;
+    p += k;
+    if (!(k = getVarint(p, end, &v)) || v > (unsigned long long)cells) return -1;
+    p += k;
+    r->moveCount = (int)v;
+
+    int prev = (r->size / 2) * r->size + r->size / 2;
+    for (int i = 0; i < r->moveCount; i++)
+    {
+        if (!(k = getVarint(p, end, &v)) || v >= 2ull * cells) return -1;
+        p += k;
+        prev += (v & 1) ? -(int)((v + 1) >> 1) : (int)(v >> 1);
+        if (prev < 0 || prev >= cells) return -1;
+        r->moves[i] = (short)prev;
+    }
+    return p == end ? 1 : -1;
+}
+
+//기보를 처음부터 plies 수까지 (음수면 끝까지) 보드에 다시 두기
+//둔 수 개수, 이미 돌이 있는 칸에 두는 수가 있으면 -1
+int replayRecord(Board *b, const GameRecord *r, int plies)
+{
+    initBoard(b, r->size);
+    if (plies < 0 || plies > r->moveCount) plies = r->moveCount;
+    char current = 'X';
+    for (int i = 0; i < plies; i++)
+    {
+        if (!placeStone(b, r->moves[i] / r->size, r->moves[i] % r->size, current))
+            return -1;
+        current = switchPlayer(current);
+    }
+    return plies;
+}
+
+//컴퓨터끼리 한 판 (탐색 budgetMs): randomSide 쪽은 처음 randomPlies 수를 돌 근처에 무작위로 두어
+//판마다 갈래가 갈리게 한다. 첫 수는 중앙, maxPlies 수에서 멈추면 결과는 RESULT_NONE
+void playSelfGame(GameRecord *r, int size, int maxPlies, int randomPlies, char randomSide,
+                  int budgetMs, unsigned long long seed)
+{
+    Board board;
+    initBoard(&board, size);
+    unsigned int rng = (unsigned int)seed;
+    *r = (GameRecord){ size, RESULT_NONE, seed, 0, { 0 } };
+
+    char current = 'X';
+    while (r->moveCount < maxPlies && r->moveCount < size * size && r->result == RESULT_NONE)
+    {
+        int ply = r->moveCount, move, depthDone;
+        if (ply == 0) move = POS(size / 2, size / 2);
+        else if (current == randomSide && ply < 2 * randomPlies)
+        {
+            int moves[MAX_MOVES];
+            int n = SIZE_DISPATCH(size, nearCellsSized, &board, 1, moves);
+            move = moves[rand_r(&rng) % n];
+        }
+        else
+        {
+            unsigned char allowed[BOARD_CELLS];
+            int restricted, kind;
+            move = threatPrecheck(&board, current, budgetMs, allowed, &restricted, &kind);
+            if (move < 0) move = findBestMove(&board, current, budgetMs, restricted ? allowed : NULL, &depthDone);
+        }
+
+        putStone(&board, move, current);
+        int cell = POS_X(move) * size + POS_Y(move);
+        r->moves[r->moveCount++] = (short)cell;
+        r->result = recordResult(&board, cell, current);
+        current = switchPlayer(current);
+    }
+}
+
+
+// ───────── 오프닝 북 ─────────
+//초반 국면 키 → 둘 수(가중치)를 정렬해 둔 이진 파일. mmap 으로 열기만 하고 읽어 들이지 않는다.
+//파일 형식 (호스트 바이트 순서):
+//  BookHeader | 색인 (2^indexBits + 1)개 | BookEntry count개 (키 → 수 순서로 정렬)
+//  색인[i] = 키의 상위 indexBits 비트가 i 이상인 첫 항목 번호 (조회 한 번에 페이지 한두 개만 건드린다)
+
+#define BOOK_MAGIC "GMKBOOK1"
+
+typedef struct
+{
+    char magic[8];
+    unsigned long long count;
+    unsigned int indexBits;
+    unsigned int reserved;
+} BookHeader;
+
+typedef struct
+{
+    unsigned long long key;     //Zobrist 국면 키 (보드 크기 포함)
+    unsigned short move;        //칸 번호
+    unsigned short weight;      //이 국면에서 이 수가 나온 횟수
+    unsigned int reserved;
+} BookEntry;
+
+static const unsigned long long *bookIndex;
+static const BookEntry *bookEntries;
+static unsigned int bookIndexBits;
+
+//북 파일 열기: 헤더·크기·색인만 확인하고 항목은 조회할 때 페이지 단위로 읽힌다, 실패하면 0
+int openBook(const char *path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size < (off_t)sizeof(BookHeader))
+    {
+        close(fd);
+        return 0;
+    }
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return 0;
+
+    const BookHeader *h = map;
+    unsigned long long indexSize = h->indexBits >= 1 && h->indexBits <= 30 ? (1ull << h->indexBits) + 1 : 0;
+    int valid = memcmp(h->magic, BOOK_MAGIC, 8) == 0 && indexSize != 0 &&
+                h->count <= (unsigned long long)st.st_size / sizeof(BookEntry) &&
+                (unsigned long long)st.st_size == sizeof(BookHeader) + indexSize * 8 + h->count * sizeof(BookEntry);
+
+    //색인은 0 에서 시작해 줄지 않고 count 로 끝나야 조회가 항목 범위를 벗어나지 않는다
+    const unsigned long long *index = (const unsigned long long *)(h + 1);
+    if (valid)
+    {
+        valid = index[0] == 0 && index[indexSize - 1] == h->count;
+        for (unsigned long long i = 1; valid && i < indexSize; i++)
+            valid = index[i - 1] <= index[i];
+    }
+    if (!valid)
+    {
+        munmap(map, (size_t)st.st_size);
+        return 0;
+    }
+    madvise(map, (size_t)st.st_size, MADV_RANDOM);
+    bookIndexBits = h->indexBits;
+    bookIndex = index;
+    bookEntries = (const BookEntry *)(bookIndex + indexSize);
+    return 1;
+}
+
+//북 조회: 현재 국면의 수들 중 가중치 비율로 하나 (칸 번호), 없으면 -1
+int bookMove(const Board *b, unsigned int *seed, int *weightOut, int *totalOut)
+{
+    if (!bookEntries) return -1;
+    unsigned long long key = b->zobristKey, bucket = key >> (64 - bookIndexBits);
+    unsigned long long lo = bookIndex[bucket], hi = bookIndex[bucket + 1];
+    while (lo < hi && bookEntries[lo].key < key) lo++;
+
+    //키가 같아도 드물게 다른 국면일 수 있으니 빈 칸인 수만 쓴다
+    int total = 0;
+    for (unsigned long long i = lo; i < hi && bookEntries[i].key == key; i++)
+        if (bookEntries[i].move < BOARD_CELLS && b->cells[bookEntries[i].move] == EMPTY)
+            total += bookEntries[i].weight;
+    if (total == 0) return -1;
+
+    int pick = (int)(rand_r(seed) % (unsigned int)total);
+    for (unsigned long long i = lo; ; i++)
+    {
+        const BookEntry *e = &bookEntries[i];
+        if (e->move >= BOARD_CELLS || b->cells[e->move] != EMPTY) continue;
+        if (pick < e->weight)
+        {
+            *weightOut = e->weight;
+            *totalOut = total;
+            return e->move;
+        }
+        pick -= e->weight;
+    }
+}
+
+//북 만들기: (키, 수)를 모아 정렬하고 같은 쌍은 가중치로 합친다
+typedef struct
+{
+    BookEntry *entries;
+    size_t count, capacity;
+} BookBuilder;
+
+static void bookAdd(BookBuilder *bb, unsigned long long key, int move)
+{
+    if (bb->count == bb->capacity)
+    {
+        bb->capacity = bb->capacity ? bb->capacity * 2 : 4096;
+        bb->entries = realloc(bb->entries, bb->capacity * sizeof(BookEntry));
+        if (!bb->entries)
+        {
+            printf("❌ 오프닝 북 메모리를 할당할 수 없습니다.\n");
+            exit(1);
+        }
+    }
+    bb->entries[bb->count++] = (BookEntry){ key, (unsigned short)move, 1, 0 };
+}
+
+static int compareBookEntry(const void *pa, const void *pb)
+{
+    const BookEntry *a = pa, *b = pb;
+    if (a->key != b->key) return a->key < b->key ? -1 : 1;
+    return (int)a->move - (int)b->move;
+}
+
+//정렬·병합 후 파일로 쓰기, 실패하면 0
+int writeBook(BookBuilder *bb, const char *path)
+{
+    qsort(bb->entries, bb->count, sizeof(BookEntry), compareBookEntry);
+    size_t n = 0;
+    for (size_t i = 0; i < bb->count; i++)
+    {
+        BookEntry *last = n ? &bb->entries[n - 1] : NULL;
+        if (last && last->key == bb->entries[i].key && last->move == bb->entries[i].move)
+        {
+            if (last->weight < 0xFFFF) last->weight++;
+        }
+        else bb->entries[n++] = bb->entries[i];
+    }
+    bb->count = n;
+
+    //버킷당 항목이 평균 4개 안팎이 되도록 색인 크기를 정한다
+    BookHeader h = { BOOK_MAGIC, n, 1, 0 };
+    while (h.indexBits < 24 && (1ull << h.indexBits) * 4 < n)
+        h.indexBits++;
+    unsigned long long buckets = 1ull << h.indexBits, *index = malloc((buckets + 1) * 8);
+    if (!index) return 0;
+    size_t at = 0;
+    for (unsigned long long i = 0; i <= buckets; i++)
+    {
+        while (at < n && (i == buckets || bb->entries[at].key >> (64 - h.indexBits) < i))
+            at++;
+        index[i] = at;
+    }
+
+    FILE *f = fopen(path, "wb");
+    int ok = f && fwrite(&h, sizeof(h), 1, f) == 1 &&
+             fwrite(index, 8, buckets + 1, f) == buckets + 1 &&
+             fwrite(bb->entries, sizeof(BookEntry), n, f) == n;
+    if (f && fclose(f) != 0) ok = 0;
+    free(index);
+    return ok;
+}
+
+//기보 한 판의 처음 plies 수를 북에 넣는다 (skipSide 쪽의 처음 skipPlies 수, 즉 무작위로 둔 수는 빼고)
+static void bookAddRecord(BookBuilder *bb, const GameRecord *r, int plies, char skipSide, int skipPlies)
+{
+    Board board;
+    initBoard(&board, r->size);
+    char current = 'X';
+    for (int i = 0; i < plies && i < r->moveCount; i++)
+    {
+        int x = r->moves[i] / r->size, y = r->moves[i] % r->size;
+        unsigned long long key = board.zobristKey;
+        if (!placeStone(&board, x, y, current)) break;
+        if (!(i > 0 && current == skipSide && i < 2 * skipPlies))
+            bookAdd(bb, key, POS(x, y));
+        current = switchPlayer(current);
+    }
+}
+
+//자가 대국으로 북 채우기: 무작위로 두는 쪽을 판마다 번갈아 바꾸고, 탐색이 고른 수만 기록한다
+void buildBookSelfPlay(BookBuilder *bb, int size, int games, int plies, int randomPlies, int budgetMs)
+{
+    unsigned long long seed = (unsigned long long)time(NULL) << 20;
+    for (int g = 0; g < games; g++)
+    {
+        GameRecord r;
+        char randomSide = (g & 1) ? 'O' : 'X';
+        playSelfGame(&r, size, plies, randomPlies, randomSide, budgetMs, seed + g);
+        bookAddRecord(bb, &r, plies, randomSide, randomPlies);
+        printf("\r📖 자가 대국 %d/%d판 (항목 %zu개)", g + 1, games, bb->count);
+        fflush(stdout);
+    }
+    printf("\n");
+}
+
+//기보 파일(이진)로 북 채우기: 읽은 판 수, 기보 파일이 아니면 -1
+int buildBookFromRecords(BookBuilder *bb, const char *path, int plies)
+{
+    FILE *f = openRecordReader(path);
+    if (!f) return -1;
+
+    GameRecord r;
+    int games = 0, status;
+    while ((status = readRecord(f, &r)) != 0 && status != -2)
+    {
+        if (status < 0) continue;
+        bookAddRecord(bb, &r, plies, 0, 0);
+        games++;
+    }
+    fclose(f);
+    return games;
+}
+
+//기보 파일(글)로 북 채우기: 한 줄에 한 판, "보드크기 행 열 행 열 ..." (1부터 세는 좌표)
+//읽은 판 수를 돌려준다 (파일을 못 열면 -1)
+int buildBookFromText(BookBuilder *bb, const char *path, int plies)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+
+    int games = 0, size, used;
+    char line[4096];
+    while (fgets(line, sizeof(line), f))
+    {
+        const char *p = line;
+        if (sscanf(p, "%d%n", &size, &used) != 1 || size < 3 || size > MAX_SIZE) continue;
+        p += used;
+
+        GameRecord r = { size, RESULT_NONE, 0, 0, { 0 } };
+        int x, y;
+        while (r.moveCount < size * size && sscanf(p, "%d %d%n", &x, &y, &used) == 2 &&
+               x >= 1 && x <= size && y >= 1 && y <= size)
+        {
+            p += used;
+            r.moves[r.moveCount++] = (short)((x - 1) * size + y - 1);
+        }
+        bookAddRecord(bb, &r, plies, 0, 0);
+        games++;
+    }
+    fclose(f);
+    return games;
+}
+
+
+
+// ───────── 생각 미리 하기 (상대 차례에 탐색) ─────────
+//사람이 수를 고민하는 동안 다른 스레드가 사람의 응수를 예측해 두고, 그 국면에서 컴퓨터의 수를 읽는다.
+//사람이 수를 두면 aiStop 으로 탐색을 멈추고 스레드가 끝나기를 기다린다 (탐색 전역 상태는 그때까지 이 스레드 것).
+//예측이 맞으면 미리 읽은 시간만큼 예산에서 빼고, 전치표에 남은 결과로 이어서 읽는다.
+
+typedef struct
+{
+    Board board;                //컴퓨터가 방금 둔 국면 (복사본)
+    int budgetMs;               //한 수 예산: 예측에는 그 1/4 을 쓴다
+    int predicted;              //예측한 사람의 수 (칸 번호, -1 이면 예측 못 함)
+    int bestMove;               //예측 국면에서 찾은 컴퓨터의 수 (-1 이면 깊이 1도 못 마침)
+    int depthDone;
+    int finished;               //멈추기 전에 탐색이 끝났는가 (승패 확정 등)
+    double searchMs;            //예측 국면을 읽은 시간
+    int running;
+    pthread_t thread;
+} Ponder;
+
+static void *ponderWorker(void *arg)
+{
+    Ponder *p = arg;
+    Board b = p->board;
+    int restricted, kind, depthDone;
+    unsigned char allowed[BOARD_CELLS];
+
+    //사람(X)의 응수 예측: 컴퓨터 차례와 같은 순서로 위협 검사 → 탐색
+    int move = threatPrecheck(&b, 'X', p->budgetMs / 4, allowed, &restricted, &kind);
+    if (move < 0) move = findBestMove(&b, 'X', p->budgetMs / 4, restricted ? allowed : NULL, &depthDone);
+    if (aiStopRequested()) return NULL;
+    p->predicted = move;
+    putStone(&b, move, 'X');
+    if (winAt(&b, move)) return NULL;
+
+    //예측 국면을 멈출 때까지 (예산 없이) 읽는다
+    double start = nowMs();
+    move = findBestMove(&b, 'O', 0, NULL, &p->depthDone);
+    p->finished = !aiStopRequested();
+    p->bestMove = p->depthDone > 0 ? move : -1;
+    p->searchMs = nowMs() - start;
+    return NULL;
+}
+
+//아직 미리 읽은 것이 없는 상태 (쓰고 난 뒤에도 이것으로 되돌린다)
+#define PONDER_NONE ((Ponder){ .predicted = -1, .bestMove = -1 })
+
+//컴퓨터가 둔 뒤 생각 미리 하기 시작
+static void startPonder(Ponder *p, const Board *b, int budgetMs)
+{
+    *p = PONDER_NONE;
+    p->board = *b;
+    p->budgetMs = budgetMs;
+    p->running = pthread_create(&p->thread, NULL, ponderWorker, p) == 0;
+}
+
+//사람이 두면 탐색을 멈추고 스레드를 거둔다
+static void stopPonder(Ponder *p)
+{
+    if (!p->running) return;
+    __atomic_store_n(&aiStop, 1, __ATOMIC_RELAXED);
+    pthread_join(p->thread, NULL);
+    __atomic_store_n(&aiStop, 0, __ATOMIC_RELAXED);
+    p->running = 0;
+}
+
+//지금 국면이 예측한 국면이면 미리 읽은 수 (칸 번호), 아니면 -1 (미리 읽은 것이 없어도 -1)
+static int ponderHit(const Ponder *p, const Board *b)
+{
+    if (p->predicted < 0 || p->bestMove < 0) return -1;
+    Board predicted = p->board;
+    putStone(&predicted, p->predicted, 'X');
+    return predicted.zobristKey == b->zobristKey ? p->bestMove : -1;
+}
+
+
+//메인 함수
+//실행 인자: [--time 한 수당 ms] [--tt 전치표 MB] [--mcts] [--threads N] [--mcts-mb 노드 풀 MB] [--ponder]
+//          [--book 북 파일] [--record 기보 파일] [--load 기보 파일 [--game N]]
+//북 만들기: --build-book 북 파일 [--from 기보 파일] [--size N] [--games N] [--plies N] [--random N]
+//자가 대국: --selfplay 판 수 --record 기보 파일 [--size N] [--random N]
+//기보 되풀이: --replay 기보 파일
+//(예: --time 500 --tt 256, --mcts --threads 0, --build-book open15.book --games 200 --time 200,
+//     --selfplay 1000 --record games.rec --time 50)
+int main(int argc, char *argv[])
+{
+    int moveBudgetMs = 1000, ttMegabytes = 64;
+    int useMcts = 0, mctsThreads = 1, mctsMegabytes = 256, usePonder = 0;
+    const char *bookPath = NULL, *buildPath = NULL, *recordsPath = NULL;
+    int bookSize = 15, bookGames = 100, bookPlies = 10, bookRandom = 3;
+    const char *recordPath = NULL, *loadPath = NULL, *replayPath = NULL;
+    int loadGame = 1, selfPlayGames = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--time") == 0 && i + 1 < argc) moveBudgetMs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--tt") == 0 && i + 1 < argc) ttMegabytes = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--mcts") == 0) useMcts = 1;
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) mctsThreads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--mcts-mb") == 0 && i + 1 < argc) mctsMegabytes = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--ponder") == 0) usePonder = 1;
+        else if (strcmp(argv[i], "--book") == 0 && i + 1 < argc) bookPath = argv[++i];
+        else if (strcmp(argv[i], "--build-book") == 0 && i + 1 < argc) buildPath = argv[++i];
+        else if (strcmp(argv[i], "--from") == 0 && i + 1 < argc) recordsPath = argv[++i];
+        else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) bookSize = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--games") == 0 && i + 1 < argc) bookGames = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--plies") == 0 && i + 1 < argc) bookPlies = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--random") == 0 && i + 1 < argc) bookRandom = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) recordPath = argv[++i];
+        else if (strcmp(argv[i], "--load") == 0 && i + 1 < argc) loadPath = argv[++i];
+        else if (strcmp(argv[i], "--game") == 0 && i + 1 < argc) loadGame = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) replayPath = argv[++i];
+        else if (strcmp(argv[i], "--selfplay") == 0 && i + 1 < argc) selfPlayGames = atoi(argv[++i]);
+    }
+    if (bookSize < 3 || bookSize > MAX_SIZE) bookSize = 15;
+    if (useMcts) usePonder = 0;     //생각 미리 하기는 PVS 전치표에 결과를 남기는 방식이라 MCTS 에는 쓰지 않는다
+    if (mctsThreads <= 0) mctsThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (useMcts && (mctsMegabytes < 1 || !initMcts(mctsMegabytes)))
+    {
+        printf("❌ MCTS 노드 풀 메모리(%dMB)를 할당할 수 없습니다.\n", mctsMegabytes);
+        return 1;
+    }
+
+    initZobrist();
+    if (ttMegabytes < 1) ttMegabytes = 1;
+    if (!initTT(ttMegabytes))
+    {
+        printf("❌ 전치표 메모리(%dMB)를 할당할 수 없습니다.\n", ttMegabytes);
+        return 1;
+    }
+
+    //북 만들기 모드
+    if (buildPath)
+    {
+        BookBuilder bb = { 0 };
+        if (recordsPath)
+        {
+            int games = buildBookFromRecords(&bb, recordsPath, bookPlies);
+            if (games < 0) games = buildBookFromText(&bb, recordsPath, bookPlies);
+            if (games < 0)
+            {
+                printf("❌ 기보 파일을 열 수 없습니다: %s\n", recordsPath);
+                return 1;
+            }
+            printf("📖 기보 %d판을 읽었습니다.\n", games);
+        }
+        else buildBookSelfPlay(&bb, bookSize, bookGames, bookPlies, bookRandom, moveBudgetMs);
+        if (!writeBook(&bb, buildPath))
+        {
+            printf("❌ 오프닝 북을 쓸 수 없습니다: %s\n", buildPath);
+            return 1;
+        }
+        printf("✅ 오프닝 북 %s (국면·수 %zu개)\n", buildPath, bb.count);
+        free(bb.entries);
+        return 0;
+    }
+    //기보 되풀이 모드: 파일을 한 판씩 읽어 placeStone 으로 끝까지 다시 두고, 기록된 결과와 맞춰 본다
+    if (replayPath)
+    {
+        FILE *f = openRecordReader(replayPath);
+        if (!f)
+        {
+            printf("❌ 기보 파일을 열 수 없습니다: %s\n", replayPath);
+            return 1;
+        }
+        long games = 0, moves = 0, broken = 0, mismatched = 0, results[4] = { 0 };
+        GameRecord r;
+        Board board;
+        int status;
+        double start = nowMs();
+        while ((status = readRecord(f, &r)) != 0)
+        {
+            if (status == -2)
+            {
+                broken++;
+                break;
+            }
+            int played = status == 1 ? replayRecord(&board, &r, -1) : -1;
+            if (played < 0)
+            {
+                broken++;
+                continue;
+            }
+            int result = played ? recordResult(&board, r.moves[played - 1], (played & 1) ? 'X' : 'O') : RESULT_NONE;
+            if (result != r.result) mismatched++;
+            results[r.result]++;
+            games++;
+            moves += played;
+        }
+        double elapsed = (nowMs() - start) / 1000.0;
+        fclose(f);
+        printf("📼 기보 %ld판, 수 %ld개 | X 승 %ld, O 승 %ld, 무 %ld, 미완 %ld | 깨진 레코드 %ld, 결과 불일치 %ld\n",
+               games, moves, results[RESULT_X], results[RESULT_O], results[RESULT_DRAW], results[RESULT_NONE],
+               broken, mismatched);
+        printf("⏱️  %.3f초 | %.0f games/sec, %.0f moves/sec\n",
+               elapsed, games / (elapsed > 0 ? elapsed : 1e-9), moves / (elapsed > 0 ? elapsed : 1e-9));
+        return 0;
+    }
+
+    //자가 대국 모드: 컴퓨터끼리 selfPlayGames 판을 두어 기보 파일에 덧붙인다
+    if (selfPlayGames > 0)
+    {
+        FILE *f = recordPath ? openRecordWriter(recordPath) : NULL;
+        if (!f)
+        {
+            printf("❌ 기보 파일을 쓸 수 없습니다: %s\n", recordPath ? recordPath : "(--record 필요)");
+            return 1;
+        }
+        unsigned long long seed = (unsigned long long)time(NULL) << 20;
+        long results[4] = { 0 };
+        for (int g = 0; g < selfPlayGames; g++)
+        {
+            GameRecord r;
+            playSelfGame(&r, bookSize, MAX_MOVES, bookRandom, (g & 1) ? 'O' : 'X', moveBudgetMs, seed + g);
+            if (!writeRecord(f, &r))
+            {
+                printf("\n❌ 기보를 쓸 수 없습니다: %s\n", recordPath);
+                fclose(f);
+                return 1;
+            }
+            results[r.result]++;
+            printf("\r🤖 자가 대국 %d/%d판 (X 승 %ld, O 승 %ld, 무 %ld)", g + 1, selfPlayGames,
+                   results[RESULT_X], results[RESULT_O], results[RESULT_DRAW]);
+            fflush(stdout);
+        }
+        printf("\n");
+        if (fclose(f) != 0)
+        {
+            printf("❌ 기보를 쓸 수 없습니다: %s\n", recordPath);
+            return 1;
+        }
+        printf("💾 기보 %d판을 %s 에 덧붙였습니다.\n", selfPlayGames, recordPath);
+        return 0;
+    }
+
+    if (bookPath && !openBook(bookPath))
+    {
+        printf("❌ 오프닝 북을 열 수 없습니다: %s\n", bookPath);
+        return 1;
+    }
+    unsigned int bookSeed = (unsigned int)time(NULL);
+
+    int SIZE = 0;
+    char buffer[100];
+    GameRecord game = { 0, RESULT_NONE, bookSeed, 0, { 0 } };
+    Board board;
+    if (loadPath)
+    {
+        //기보 파일의 loadGame 번째 판을 불러와 이어서 둔다
+        FILE *f = openRecordReader(loadPath);
+        int status = 0;
+        for (int g = 0; f && g < loadGame && (status = readRecord(f, &game)) == 1; g++)
+            ;
+        if (f) fclose(f);
+        if (status != 1 || loadGame < 1 || replayRecord(&board, &game, -1) < 0)
+        {
+            printf("❌ 기보를 불러올 수 없습니다: %s (%d번째 판)\n", loadPath, loadGame);
+            return 1;
+        }
+        SIZE = game.size;
+        printf("📂 %s 의 %d번째 판을 불러왔습니다. (%d수)\n", loadPath, loadGame, game.moveCount);
+    }
+    else
+    {
+        while (1)
+        {
+            printf("보드 크기 입력 (3~19): ");
+            fgets(buffer, sizeof(buffer), stdin);
+            sscanf(buffer, "%d", &SIZE);
+            if (SIZE >=3 && SIZE <= 19) break;
+            else printf("범위에 맞는 수를 입력하세요 (3~19)\n");
+        }
+        initBoard(&board, SIZE);
+        game.size = SIZE;
+    }
+
+    printf("🎮 오목 (%dx%d 보드, %d개를 먼저 이으면 승리, 한 수당 %dms)\n", SIZE, SIZE, winLength, moveBudgetMs);
+    printf("당신은 X입니다. (전치표 %dMB, 항목 %llu개)\n", ttMegabytes, (ttMask + 1) * TT_WAYS);
+    printBoard(&board);
+
+    char current = (game.moveCount & 1) ? 'O' : 'X';
+    if (game.moveCount > 0 && recordResult(&board, game.moves[game.moveCount - 1], switchPlayer(current)) != RESULT_NONE)
+    {
+        printf("🏁 이미 끝난 판입니다.\n");
+        return 0;
+    }
+    Ponder ponder = PONDER_NONE;
+    while (1)
+    {
+        int x, y;
+        if (current == 'X')
+        {
+            printf("플레이어 차례입니다. (행 열 입력): ");
+            if (!fgets(buffer, sizeof(buffer), stdin)) break;
+            if (sscanf(buffer, "%d %d", &x, &y) != 2 || !placeStone(&board, x - 1, y - 1, current))
+            {
+                printf("❌ 잘못된 입력입니다. (1~%d 사이의 빈 칸)\n", SIZE);
+                continue;
+            }
+            stopPonder(&ponder);
+        }
+        else
+        {
+            //컴퓨터 차례
+            printf("컴퓨터 차례입니다...\n");
+            int depthDone, move, weight, total, restricted = 0, kind, fromPonder = 0;
+            unsigned char allowed[BOARD_CELLS];
+            long playouts;
+            Ponder used = ponder;       //미리 읽은 결과는 이번 수에만 쓴다
+            ponder = PONDER_NONE;
+            double start = nowMs();
+            int fromBook = (move = bookMove(&board, &bookSeed, &weight, &total)) >= 0, fromThreat = 0;
+            if (!fromBook)
+                fromThreat = (move = threatPrecheck(&board, current, moveBudgetMs, allowed, &restricted, &kind)) >= 0;
+            double threatMs = nowMs() - start;
+            if (!fromBook && !fromThreat)
+            {
+                const unsigned char *only = restricted ? allowed : NULL;
+                int budget = moveBudgetMs > threatMs ? moveBudgetMs - (int)threatMs : 1;
+                int hit = usePonder ? ponderHit(&used, &board) : -1;
+                if (hit >= 0 && (!only || only[hit]))
+                {
+                    //예측 적중: 예산을 다 쓸 만큼 읽었으면 그 수를 두고, 아니면 남은 예산으로 이어 읽는다
+                    printf("🔮 예측 적중: 상대 차례에 %d수 깊이까지 미리 탐색 (%.0fms)\n",
+                           used.depthDone, used.searchMs);
+                    fromPonder = used.finished || used.searchMs >= budget;
+                    budget = fromPonder ? 0 : budget - (int)used.searchMs;
+                }
+                if (fromPonder)
+                {
+                    move = hit;
+                    depthDone = used.depthDone;
+                }
+                else if (useMcts) move = findBestMoveMcts(&board, current, budget, mctsThreads, only, &playouts);
+                else move = findBestMove(&board, current, budget, only, &depthDone);
+            }
+            double elapsed = nowMs() - start;
+            x = POS_X(move) + 1;
+            y = POS_Y(move) + 1;
+            placeStone(&board, x - 1, y - 1, current);
+            printf("🤖 컴퓨터가 (%d, %d)에 둡니다.\n", x, y);
+            if (restricted)
+                printf("🛡️  상대의 VCF 를 막는 수 %d개 중에서 고릅니다. (위협 해결기 노드 %ld개, %.0fms)\n",
+                       restricted, threatNodes, threatMs);
+            if (fromBook)
+                printf("📖 오프닝 북 수 (가중치 %d/%d)\n", weight, total);
+            else if (fromThreat)
+                printf("⚔️  %s 필승 수순 (위협 해결기 노드 %ld개, %.0fms)\n",
+                       kind == THREAT_VCF ? "VCF" : "VCT", threatNodes, threatMs);
+            else if (fromPonder)
+                printf("🔮 미리 읽은 수를 그대로 둡니다.\n");
+            else if (useMcts)
+                printf("🌲 플레이아웃 %ld회 (%.0f playouts/sec, 스레드 %d개) | 노드 %d개, %.1fMB\n",
+                       playouts, playouts / (elapsed / 1000.0), mctsThreads, mctsUsed,
+                       mctsUsed * (double)sizeof(MctsNode) / (1 << 20));
+            else
+                printf("🔍 %d수 깊이까지 탐색 (%.0fms, 노드 %ld개, 전치표 적중 %ld/%ld)\n",
+                       depthDone, elapsed, aiNodes, ttHits, ttProbes);
+        }
+        printBoard(&board);
+        game.moves[game.moveCount++] = (short)((x - 1) * SIZE + y - 1);
+
+        int result = checkWin(&board, x - 1, y - 1);
+        if (result == 1)
+        {
+            printf(current == 'X' ? "🎉 플레이어 승리!\n" : "💻 컴퓨터 승리!\n");
+            game.result = current == 'X' ? RESULT_X : RESULT_O;
+            break;
+        }
+        if (result == 2)
+        {
+            printf("🤝 무승부입니다!\n");
+            game.result = RESULT_DRAW;
+            break;
+        }
+        current = switchPlayer(current);
+
+        //사람이 고민하는 동안 다음 수를 미리 읽는다
+        if (usePonder && current == 'X') startPonder(&ponder, &board, moveBudgetMs);
+    }
+    stopPonder(&ponder);
+
+    //--record 가 있으면 (끝나지 않은 판도) 기보 파일에 덧붙인다
+    if (recordPath)
+    {
+        FILE *f = openRecordWriter(recordPath);
+        if (!f || !writeRecord(f, &game) || fclose(f) != 0)
+        {
+            printf("❌ 기보를 쓸 수 없습니다: %s\n", recordPath);
+            return 1;
+        }
+        printf("💾 기보를 %s 에 저장했습니다. (%d수)\n", recordPath, game.moveCount);
+    }
     return 0;
 }
\ No newline at end of file
@@ -1,16 +1,18 @@
-// tetris_termux.c
+// tetris_not_mine.c
 // Termux / code-server 터미널용 완성형 테트리스 (C)
-// 컴파일: gcc tetris_termux.c -o tetris -O2
-// 실행: ./tetris
+// 컴파일: gcc tetris_not_mine.c -o tetris -O2
+// 실행: ./tetris [--ai] [--bench 조각 수 [시드]]
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <termios.h>
-#include <sys/select.h>
+#include <poll.h>
+#include <errno.h>
 #include <time.h>
 #include <signal.h>
+#include <stdint.h>
 
 #define WIDTH 10
 #define HEIGHT 20
@@ -30,8 +32,30 @@
 // 블록 타입 인덱스
 enum { I_T=0, O_T, T_T, S_T, Z_T, J_T, L_T, TYPE_COUNT };
 
-// 게임 필드: 0 = 빈칸, 1..7 = 블록타입+1
-int field[HEIGHT][WIDTH];
+// 게임 필드 (행 비트마스크): 충돌 검사용. 열 x 는 비트 x + COL_PAD,
+// 양옆 COL_PAD 비트는 벽, 위아래 ROW_PAD 행은 각각 벽만 있는 행 / 꽉 찬 바닥 행이라
+// 4x4 상자가 어디 있든 범위 검사 없이 시프트-AND 네 번으로 충돌을 본다
+#define COL_PAD 3
+#define ROW_PAD 4
+#if WIDTH + 2 * COL_PAD > 16
+#error "WIDTH + 2 * COL_PAD must fit in 16 bits"
+#endif
+#define FULL_ROW  ((uint16_t)0xFFFF)
+#define EMPTY_ROW ((uint16_t)~(((1u << WIDTH) - 1) << COL_PAD))
+#define COLS_MASK ((uint16_t)~EMPTY_ROW)
+
+// 게임 상태 (headless): 터미널·입력과 상관없이 이것만으로 한 판을 진행한다
+typedef struct {
+    uint16_t rows[ROW_PAD + HEIGHT + ROW_PAD]; // 행 비트마스크 (충돌용)
+    unsigned char color[HEIGHT][WIDTH];        // 색 평면: 0 = 빈칸, 1..7 = 블록타입+1 (그리기 전용)
+    int score, level, lines;
+} GameState;
+
+#define ROW(g, y) (g)->rows[(y) + ROW_PAD]
+
+// 조각이 나오는 자리 (4x4 상자 왼쪽 위)
+#define SPAWN_X ((WIDTH / 2) - 2) // 중앙에 배치
+#define SPAWN_Y (-1)              // spawn slightly above board so O/I can appear well
 
 // 현재 조각 정보
 typedef struct {
@@ -40,10 +64,9 @@ typedef struct {
     int x, y;       // 좌표: (x,y) 기준은 블록의 4x4 좌표 상단 왼쪽
 } Piece;
 
+// 터미널 게임의 상태
+GameState game;
 Piece curPiece, nextPiece;
-int level = 1;
-int score = 0;
-int lines_cleared = 0;
 int game_over = 0;
 int paused = 0;
 
@@ -70,17 +93,22 @@ void enable_raw_mode(void) {
     printf("\033[?25l"); // cursor hide
 }
 
-// 키 입력 대기 없이 읽기 (select 사용)
-int read_key_nonblock() {
-    fd_set set;
-    struct timeval tv = {0, 0};
-    FD_ZERO(&set);
-    FD_SET(STDIN_FILENO, &set);
-    if (select(STDIN_FILENO+1, &set, NULL, NULL, &tv) > 0) {
-        unsigned char c;
-        if (read(STDIN_FILENO, &c, 1) == 1) return c;
-    }
-    return -1;
+// 입력이 오거나 timeout_ms 가 지날 때까지 잠들기 (-1 = 입력이 올 때까지)
+// 입력이 있으면 쌓인 키를 keys 에 모두 읽어 그 개수를, 시간이 다 되면 0 을, 입력이 닫혔으면 -1 을 돌려준다
+int wait_keys(int timeout_ms, unsigned char *keys, int cap) {
+    struct pollfd pfd = { STDIN_FILENO, POLLIN, 0 };
+    int r = poll(&pfd, 1, timeout_ms);
+    if (r <= 0) return 0; // timeout 또는 EINTR
+    ssize_t n = read(STDIN_FILENO, keys, cap);
+    if (n == 0 || (n < 0 && errno != EINTR && errno != EAGAIN)) return -1;
+    return n > 0 ? (int)n : 0;
+}
+
+// 단조 시계 (ms)
+unsigned long now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
 }
 
 // 화면 제어
@@ -140,69 +168,109 @@ int shape4[7][4][4] = {
     }
 };
 
+// (type, rot)별 4x4 모양 마스크: 비트 ry*4 + rx 가 (rx, ry) 칸 (init_piece_masks 에서 한 번 계산)
+uint16_t piece_mask[TYPE_COUNT][4];
+
+// shape4 를 시계 방향으로 rot 번 돌린 마스크 미리 계산
+// mapping: for rot=1 (90deg): new[x][y] = old[3-y][x]
+void init_piece_masks(void) {
+    for (int type = 0; type < TYPE_COUNT; ++type)
+    for (int rot = 0; rot < 4; ++rot) {
+        uint16_t m = 0;
+        for (int ry = 0; ry < 4; ++ry) for (int rx = 0; rx < 4; ++rx) {
+            int tx, ty;
+            if (rot == 0) { tx = rx; ty = ry; }
+            else if (rot == 1) { tx = 3 - ry; ty = rx; }
+            else if (rot == 2) { tx = 3 - rx; ty = 3 - ry; }
+            else { tx = ry; ty = 3 - rx; }
+            if (shape4[type][ty][tx]) m |= 1u << (ry * 4 + rx);
+        }
+        piece_mask[type][rot] = m;
+    }
+}
+
 // rotation: 0..3, return 1 if block present at (rx,ry) in rotated 4x4
-int block_at(int type, int rot, int rx, int ry) {
-    // rotation about 4x4 square clockwise rot times
-    // mapping: for rot=1 (90deg): new[x][y] = old[3-y][x]
-    int x = rx, y = ry;
-    int tx, ty;
-    int val = 0;
-    if (rot == 0) val = shape4[type][ry][rx];
-    else if (rot == 1) { tx = 3 - ry; ty = rx; val = shape4[type][ty][tx]; }
-    else if (rot == 2) { tx = 3 - rx; ty = 3 - ry; val = shape4[type][ty][tx]; }
-    else { tx = ry; ty = 3 - rx; val = shape4[type][ty][tx]; }
-    return val;
+static inline int block_at(int type, int rot, int rx, int ry) {
+    return piece_mask[type][rot] >> (ry * 4 + rx) & 1;
+}
+
+// 모양 마스크의 ry 번째 줄(4비트)을 필드 행 비트 위치로 옮긴 것
+static inline uint16_t piece_row(uint16_t mask, int ry, int px) {
+    return (uint16_t)(((mask >> (ry * 4)) & 0xF) << (px + COL_PAD));
+}
+
+// 새 판: 필드 비우기 (두 평면 모두), 점수·레벨·줄 수 초기화
+void reset_state(GameState *g) {
+    memset(g->color, 0, sizeof(g->color));
+    for (int y = -ROW_PAD; y < HEIGHT + ROW_PAD; ++y)
+        ROW(g, y) = y < HEIGHT ? EMPTY_ROW : FULL_ROW;
+    g->score = 0;
+    g->level = 1;
+    g->lines = 0;
 }
 
 // 충돌 검사: piece를 (px,py,rot)로 놓을 수 있는가?
-int collide_piece(int type, int rot, int px, int py) {
-    for (int ry = 0; ry < 4; ++ry) {
-        for (int rx = 0; rx < 4; ++rx) {
-            if (!block_at(type, rot, rx, ry)) continue;
-            int fx = px + rx;
-            int fy = py + ry;
-            if (fx < 0 || fx >= WIDTH) return 1;
-            if (fy >= HEIGHT) return 1;
-            if (fy >= 0 && field[fy][fx]) return 1;
-        }
-    }
-    return 0;
+// 상자가 패딩 밖으로 나가는 위치는 (모양이 어느 칸을 쓰든) 벽이나 바닥에 걸리므로 바로 충돌
+static inline int collide_piece(const GameState *g, int type, int rot, int px, int py) {
+    if (px < -COL_PAD || px > WIDTH - 1 || py < -ROW_PAD || py > HEIGHT) return 1;
+    uint16_t m = piece_mask[type][rot];
+    const uint16_t *r = &ROW(g, py);
+    return ((piece_row(m, 0, px) & r[0]) | (piece_row(m, 1, px) & r[1]) |
+            (piece_row(m, 2, px) & r[2]) | (piece_row(m, 3, px) & r[3])) != 0;
 }
 
 // 현재 조각을 필드에 병합 (고정)
-void merge_piece(Piece *p) {
-    for (int ry=0; ry<4; ++ry) for (int rx=0; rx<4; ++rx) {
-        if (!block_at(p->type, p->rot, rx, ry)) continue;
-        int fx = p->x + rx;
-        int fy = p->y + ry;
+void merge_piece(GameState *g, const Piece *p) {
+    uint16_t m = piece_mask[p->type][p->rot];
+    for (int ry = 0; ry < 4; ++ry) {
+        if (p->y + ry >= 0 && p->y + ry < HEIGHT) ROW(g, p->y + ry) |= piece_row(m, ry, p->x);
+    }
+    for (; m; m &= m - 1) {
+        int bit = __builtin_ctz(m);
+        int fx = p->x + bit % 4;
+        int fy = p->y + bit / 4;
         if (fy >= 0 && fy < HEIGHT && fx >= 0 && fx < WIDTH) {
-            field[fy][fx] = p->type + 1; // 저장할 때 1..7
+            g->color[fy][fx] = p->type + 1; // 저장할 때 1..7
         }
     }
 }
 
-// 한 줄 지우기 검사 및 처리
-void clear_lines_and_score() {
-    int cleared = 0;
-    for (int y = HEIGHT-1; y >= 0; --y) {
-        int full = 1;
-        for (int x = 0; x < WIDTH; ++x) if (!field[y][x]) { full = 0; break; }
-        if (full) {
+// 꽉 찬 행 지우기: 행 마스크가 FULL_ROW 인 행을 빼고 남은 행을 아래부터 한 번에 당겨 채운다
+// 지운 행 번호(지우기 전 기준, 아래쪽부터)를 rows 에 적고 (NULL 이면 생략) 지운 줄 수를 돌려준다
+// 조각 하나를 고정한 뒤에는 많아야 4줄이다
+int clear_full_rows(GameState *g, int rows[4]) {
+    int cleared = 0, dst = HEIGHT - 1;
+    for (int y = HEIGHT - 1; y >= 0; --y) {
+        if (ROW(g, y) == FULL_ROW) {
+            if (rows && cleared < 4) rows[cleared] = y;
             cleared++;
-            // 위로 한 칸씩 내리기
-            for (int yy = y; yy > 0; --yy) for (int x=0;x<WIDTH;++x) field[yy][x] = field[yy-1][x];
-            for (int x=0;x<WIDTH;++x) field[0][x] = 0;
-            ++y; // 같은 행 다시 검사 (since rows moved down)
+            continue;
         }
+        if (dst != y) {
+            ROW(g, dst) = ROW(g, y);
+            memcpy(g->color[dst], g->color[y], WIDTH);
+        }
+        dst--;
+    }
+    for (; dst >= 0; --dst) {
+        ROW(g, dst) = EMPTY_ROW;
+        memset(g->color[dst], 0, WIDTH);
     }
+    return cleared;
+}
+
+// 한 줄 지우기 검사 및 처리: 지운 행은 cleared_rows 에 (clear_full_rows 참고), 지운 줄 수를 돌려준다
+int clear_lines_and_score(GameState *g, int cleared_rows[4]) {
+    int cleared = clear_full_rows(g, cleared_rows);
     if (cleared) {
-        lines_cleared += cleared;
+        g->lines += cleared;
         // 일반 테트리스식 점수: 1줄=100, 2줄=300, 3줄=500, 4줄=800 (간단 가중치)
         static int scoreTable[5] = {0,100,300,500,800};
-        score += scoreTable[cleared] * level;
+        g->score += scoreTable[cleared] * g->level;
         // 레벨업: 예시로 10라인마다 레벨업
-        if (lines_cleared >= level * 10) { level++; }
+        if (g->lines >= g->level * 10) { g->level++; }
     }
+    return cleared;
 }
 
 // 랜덤 조각 생성
@@ -210,11 +278,235 @@ Piece make_random_piece() {
     Piece p;
     p.type = rand() % TYPE_COUNT;
     p.rot = 0;
-    p.x = (WIDTH / 2) - 2; // 중앙에 배치
-    p.y = -1; // spawn slightly above board so O/I can appear well
+    p.x = SPAWN_X;
+    p.y = SPAWN_Y;
     return p;
 }
 
+// 하드 드롭 (즉시 내려서 고정): 지운 줄 수
+int hard_drop(GameState *g, Piece *p) {
+    while (!collide_piece(g, p->type, p->rot, p->x, p->y + 1)) p->y++;
+    merge_piece(g, p);
+    return clear_lines_and_score(g, NULL);
+}
+
+// 놓을 자리 (회전, 상자 왼쪽 열)
+typedef struct {
+    int rot, x;
+} Placement;
+
+// 나오는 자리에서 0 → pl.rot 으로 돌리고 옆으로 pl.x 까지 밀 수 있는가 (벽 차기 없이)
+int placement_reachable(const GameState *g, int type, Placement pl) {
+    for (int r = 0; r <= pl.rot; ++r)
+        if (collide_piece(g, type, r, SPAWN_X, SPAWN_Y)) return 0;
+    int step = pl.x < SPAWN_X ? -1 : 1;
+    for (int x = SPAWN_X; x != pl.x; x += step)
+        if (collide_piece(g, type, pl.rot, x + step, SPAWN_Y)) return 0;
+    return 1;
+}
+
+// 이미 내려앉은 자리의 조각 p 를 고정한 결과를 out 에 (out == g 도 됨): 지운 줄 수
+int land_piece(GameState *out, const GameState *g, const Piece *p, int cleared_rows[4]) {
+    if (out != g) *out = *g;
+    merge_piece(out, p);
+    return clear_lines_and_score(out, cleared_rows);
+}
+
+// 닿을 수 있는지 보지 않고 떨어뜨리기 (place_piece 참고, 호출하는 쪽이 이미 확인했을 때)
+int drop_piece(GameState *out, const GameState *g, int type, Placement pl,
+               Piece *landed, int cleared_rows[4]) {
+    Piece p = { type, pl.rot, pl.x, SPAWN_Y };
+    while (!collide_piece(g, p.type, p.rot, p.x, p.y + 1)) p.y++;
+    if (landed) *landed = p;
+    return land_piece(out, g, &p, cleared_rows);
+}
+
+// headless 한 수: g 에 type 조각을 pl 자리로 떨어뜨린 결과를 out 에 (out == g 도 됨)
+// 지운 줄 수를 돌려주고 (닿을 수 없는 자리면 -1, out 은 그대로), 내려앉은 조각은 *landed,
+// 지운 행은 cleared_rows 에 적는다 (clear_full_rows 참고, 둘 다 NULL 이면 생략)
+int place_piece(GameState *out, const GameState *g, int type, Placement pl,
+                Piece *landed, int cleared_rows[4]) {
+    if (!placement_reachable(g, type, pl)) return -1;
+    return drop_piece(out, g, type, pl, landed, cleared_rows);
+}
+
+// ───── AI (Dellacherie 특징 평가) ─────
+// 현재 조각의 모든 (회전, 열) 하드 드롭을 place_piece 로 두어 보고, 결과 필드를
+// Pierre Dellacherie 의 특징 6개 (착지 높이, 깎인 칸, 행/열 전이, 구멍, 우물)의 가중합으로 평가한다.
+// 특징은 모두 행 비트마스크로 센다 (전이·구멍은 행마다 popcount 한 번)
+
+#define W_LANDING_HEIGHT -4.500158825082766
+#define W_ERODED_CELLS    3.4181268101392694
+#define W_ROW_TRANSITIONS -3.2178882868487753
+#define W_COL_TRANSITIONS -9.348695305445199
+#define W_HOLES          -7.899265427351652
+#define W_WELLS          -3.3855972247263626
+
+// 행 전이를 셀 비트 쌍: 왼쪽 벽-첫 열, ..., 마지막 열-오른쪽 벽
+#define ROW_PAIR_MASK ((uint16_t)(((1u << (WIDTH + 1)) - 1) << (COL_PAD - 1)))
+
+// 16비트 popcount (SWAR): -mpopcnt 없이 __builtin_popcount 는 라이브러리 호출이 되어 평가가 몇 배 느려진다
+static inline int popcount16(uint16_t x) {
+    unsigned v = x;
+    v = v - ((v >> 1) & 0x5555);
+    v = (v & 0x3333) + ((v >> 2) & 0x3333);
+    v = (v + (v >> 4)) & 0x0F0F;
+    return (v + (v >> 8)) & 0x1F;
+}
+
+// 모양이 같은 회전 (O 의 네 회전 등)은 한 번만 본다 (init_piece_masks 뒤 init_ai 에서 계산)
+int rot_distinct[TYPE_COUNT][4];
+
+// (type, rot) 모양의 열 rx 에서 가장 아래 칸의 ry (그 열이 비었으면 -1)
+signed char piece_bottom[TYPE_COUNT][4][4];
+
+// 모양 마스크를 왼쪽 위로 붙인 것 (회전끼리 모양 비교용)
+static uint16_t normalize_mask(uint16_t m) {
+    while (!(m & 0x000F)) m >>= 4;
+    while (!(m & 0x1111)) m = (m >> 1) & 0x7777;
+    return m;
+}
+
+void init_ai(void) {
+    for (int t = 0; t < TYPE_COUNT; ++t)
+    for (int r = 0; r < 4; ++r) {
+        rot_distinct[t][r] = 1;
+        for (int q = 0; q < r; ++q)
+            if (normalize_mask(piece_mask[t][q]) == normalize_mask(piece_mask[t][r])) rot_distinct[t][r] = 0;
+        for (int rx = 0; rx < 4; ++rx) {
+            piece_bottom[t][r][rx] = -1;
+            for (int ry = 0; ry < 4; ++ry)
+                if (block_at(t, r, rx, ry)) piece_bottom[t][r][rx] = ry;
+        }
+    }
+}
+
+// 열마다 가장 위에 찬 칸의 행 (빈 열은 HEIGHT): 위에서 곧장 떨어지는 조각은 여기서 멈춘다
+static void column_tops(const GameState *g, int top[WIDTH]) {
+    for (int c = 0; c < WIDTH; ++c) top[c] = HEIGHT;
+    uint16_t seen = 0;
+    for (int y = 0; y < HEIGHT && seen != COLS_MASK; ++y) {
+        for (uint16_t fresh = ROW(g, y) & COLS_MASK & ~seen; fresh; fresh &= fresh - 1)
+            top[__builtin_ctz(fresh) - COL_PAD] = y;
+        seen |= ROW(g, y) & COLS_MASK;
+    }
+}
+
+// 놓은 결과 평가 (클수록 좋음): landed = 내려앉은 조각, 지운 행은 cleared_rows (지우기 전 기준)
+double evaluate_placement(const GameState *g, const Piece *landed, int lines, const int cleared_rows[4]) {
+    uint16_t m = piece_mask[landed->type][landed->rot];
+    int top = __builtin_ctz(m) / 4, bottom = (31 - __builtin_clz(m)) / 4;
+    double landing = HEIGHT - landed->y - (top + bottom) / 2.0;
+
+    // 깎인 칸: 지운 줄 수 × 지운 행에 들어간 이 조각의 칸 수
+    int eroded = 0;
+    for (int i = 0; i < lines && i < 4; ++i)
+        eroded += popcount16((m >> ((cleared_rows[i] - landed->y) * 4)) & 0xF);
+    eroded *= lines;
+
+    // 맨 위 빈 행들은 행 전이 2개씩이고 나머지 특징은 (바로 아래 행과의 열 전이 말고는) 0 이라 건너뛴다
+    int y = 0;
+    while (y < HEIGHT && ROW(g, y) == EMPTY_ROW) ++y;
+    int row_trans = 2 * y, col_trans = 0, holes = 0, wells = 0;
+    if (y > 0) col_trans = popcount16(ROW(g, y) & COLS_MASK);
+    uint16_t above = 0, in_well = 0;
+    unsigned char depth[16] = { 0 };
+    for (; y < HEIGHT; ++y) {
+        uint16_t r = ROW(g, y);
+        row_trans += popcount16((r ^ (r >> 1)) & ROW_PAIR_MASK);
+        col_trans += popcount16((r ^ ROW(g, y + 1)) & COLS_MASK);
+        holes += popcount16(above & ~r & COLS_MASK);
+        above |= r;
+        // 우물 칸: 비었고 양옆이 (벽 포함) 찬 칸. 이어진 우물은 깊이 1, 2, 3 ... 을 더한다
+        uint16_t well = ~r & (uint16_t)(r << 1) & (r >> 1) & COLS_MASK;
+        for (uint16_t w = well; w; w &= w - 1) {
+            int c = __builtin_ctz(w);
+            depth[c] = (in_well >> c & 1) ? depth[c] + 1 : 1;
+            wells += depth[c];
+        }
+        in_well = well;
+    }
+
+    return W_LANDING_HEIGHT * landing + W_ERODED_CELLS * eroded +
+           W_ROW_TRANSITIONS * row_trans + W_COL_TRANSITIONS * col_trans +
+           W_HOLES * holes + W_WELLS * wells;
+}
+
+// (rot, x) 로 나온 조각이 떨어져 멈추는 행 (drop_piece 와 같은 결과)
+// 조각이 모든 열 꼭대기보다 위에 있으면 열 높이만으로 바로 구하고, 나오는 상자가 이미 어느 열
+// 꼭대기에 걸쳐 있으면 (꼭대기가 나오는 자리까지 올라온 높은 쌓임) 한 칸씩 내려 본다
+static int landing_row(const GameState *g, const int top[WIDTH], int type, int rot, int x) {
+    int y = HEIGHT;
+    for (int rx = 0; rx < 4; ++rx) {
+        int b = piece_bottom[type][rot][rx];
+        if (b >= 0 && top[x + rx] - 1 - b < y) y = top[x + rx] - 1 - b;
+    }
+    if (y < SPAWN_Y || collide_piece(g, type, rot, x, y)) {
+        for (y = SPAWN_Y; !collide_piece(g, type, rot, x, y + 1); ++y)
+            ;
+    }
+    return y;
+}
+
+// type 조각을 둘 가장 좋은 자리 (닿을 수 있는 자리가 없으면 rot = -1)
+// *tried 에 평가한 자리 수를 더한다 (NULL 이면 생략)
+Placement ai_choose(const GameState *g, int type, long *tried) {
+    Placement best = { -1, SPAWN_X };
+    double best_score = 0;
+    GameState next;
+    int cleared_rows[4], top[WIDTH];
+    column_tops(g, top);
+    for (int rot = 0; rot < 4; ++rot) {
+        // 나오는 자리에서 돌릴 수 없으면 더 돌린 모양도 못 만든다
+        if (collide_piece(g, type, rot, SPAWN_X, SPAWN_Y)) break;
+        if (!rot_distinct[type][rot]) continue;
+        // 나오는 열에서 양옆으로 밀다가 막히면 그 너머는 닿을 수 없다 (placement_reachable 과 같은 규칙)
+        for (int step = -1; step <= 1; step += 2) {
+            for (int x = step < 0 ? SPAWN_X : SPAWN_X + 1; !collide_piece(g, type, rot, x, SPAWN_Y); x += step) {
+                Piece landed = { type, rot, x, landing_row(g, top, type, rot, x) };
+                Placement pl = { rot, x };
+                int lines = land_piece(&next, g, &landed, cleared_rows);
+                if (tried) ++*tried;
+                double v = evaluate_placement(&next, &landed, lines, cleared_rows);
+                if (best.rot < 0 || v > best_score) {
+                    best = pl;
+                    best_score = v;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+// 배치 모드: 화면 없이 AI 로 pieces 개를 실제로 두고 속도를 잰다 (판이 끝나면 새 판, 못 둔 조각은 세지 않는다)
+void run_batch(long pieces, unsigned int seed) {
+    GameState g;
+    reset_state(&g);
+    long placements = 0, total_lines = 0;
+    int games = 1, best_lines = 0;
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (long placed = 0; placed < pieces; ) {
+        int type = rand_r(&seed) % TYPE_COUNT;
+        Placement pl = ai_choose(&g, type, &placements);
+        int lines = pl.rot < 0 ? -1 : place_piece(&g, &g, type, pl, NULL, NULL);
+        if (lines < 0) { // 나올 자리가 막힘 = 게임 오버
+            if (g.lines > best_lines) best_lines = g.lines;
+            reset_state(&g);
+            games++;
+            continue;
+        }
+        total_lines += lines;
+        placed++;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    if (g.lines > best_lines) best_lines = g.lines;
+    double sec = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+    printf("AI batch: %ld pieces, %ld lines, %d game(s) (best %d lines)\n", pieces, total_lines, games, best_lines);
+    printf("%.3fs | %.0f pieces/sec, %.0f placements/sec\n",
+           sec, pieces / (sec > 0 ? sec : 1e-9), placements / (sec > 0 ? sec : 1e-9));
+}
+
 // 색상 매핑
 const char* color_for_type(int t) {
     switch(t) {
@@ -229,70 +521,135 @@ const char* color_for_type(int t) {
     }
 }
 
-// 필드와 HUD 그리기
+// ───── 화면 버퍼 (diff 렌더러) ─────
+// 한 프레임을 칸 배열로 만든 뒤 직전 프레임과 비교해 바뀐 칸만 커서 이동 + 색 시퀀스로 내보낸다.
+// 출력은 out_buf 에 모아 write() 한 번으로 보낸다 (stdio 버퍼를 거치지 않음)
+
+#define SCREEN_W (WIDTH + 2)            // 테두리 포함 보드 칸 수 (한 칸 = 화면 2글자)
+#define SCREEN_H (HEIGHT + 2)
+#define HUD_COL  (2 * SCREEN_W + 1)     // HUD 가 시작하는 화면 열
+#define NEXT_ROW 6                      // NEXT 미리보기 4x4 가 시작하는 필드 행
+#define HUD_LEN  64
+#define CELL_WALL 8                     // 칸 색 코드: 0 = 빈칸, 1..7 = 블록타입+1, 8 = 벽
+
+typedef struct {
+    unsigned char cells[SCREEN_H][SCREEN_W];
+    unsigned char next[4][4];
+    char hud[SCREEN_H][HUD_LEN];        // 필드 행 y 의 HUD 는 hud[y + 1]
+} Frame;
+
+static Frame frames[2];                 // frames[front] = 화면에 나가 있는 프레임
+static int front = 0;
+static int frame_valid = 0;             // 0 이면 다음 프레임은 전부 다시 그린다
+
+static char out_buf[1 << 16];
+static int out_len;
+static int out_row, out_col;            // 터미널 커서 위치 (-1 = 모름)
+static int out_color;                   // 지금 걸려 있는 배경 색 코드 (-1 = 모름)
+
+// 화면을 지웠거나 다른 출력이 끼어들었을 때: 다음 draw_all 은 전체를 다시 그린다
+void invalidate_frame(void) { frame_valid = 0; }
+
+static void out_flush(void) {
+    for (int done = 0; done < out_len; ) {
+        ssize_t n = write(STDOUT_FILENO, out_buf + done, out_len - done);
+        if (n <= 0) break;
+        done += n;
+    }
+    out_len = 0;
+}
+
+static void out_bytes(const char *s, int n) {
+    if (out_len + n > (int)sizeof(out_buf)) out_flush();
+    memcpy(out_buf + out_len, s, n);
+    out_len += n;
+}
+
+static void out_str(const char *s) { out_bytes(s, strlen(s)); }
+
+static void out_goto(int row, int col) {
+    if (row == out_row && col == out_col) return;
+    char seq[16];
+    out_bytes(seq, snprintf(seq, sizeof(seq), "\033[%d;%dH", row, col));
+    out_row = row;
+    out_col = col;
+}
+
+static void out_cell(int row, int col, int color) {
+    out_goto(row, col);
+    if (color != out_color) {
+        out_str(color == CELL_WALL ? BG_WALL : color ? color_for_type(color - 1) : BG_RESET);
+        out_color = color;
+    }
+    out_bytes("  ", 2);
+    out_col += 2;
+}
+
+// 필드와 HUD 그리기: 새 프레임을 뒤 버퍼에 만들고 앞 버퍼와 다른 곳만 내보낸다
 void draw_all(Piece *p, Piece *nextP) {
-    // move cursor to top-left
-    gotoxy(1,1);
-    // 좌측: 보드 (테두리 포함)
-    printf(FG_TEXT);
-    for (int y = -1; y <= HEIGHT; ++y) {
-        for (int x = -1; x <= WIDTH; ++x) {
-            if (y == -1 || y == HEIGHT || x == -1 || x == WIDTH) {
-                // border
-                printf(BG_WALL "  " BG_RESET);
-            } else {
-                // check current falling piece occupies this cell?
-                int occupied = 0;
-                if (p) {
-                    for (int ry=0; ry<4 && !occupied; ++ry) for (int rx=0; rx<4; ++rx) {
-                        if (!block_at(p->type, p->rot, rx, ry)) continue;
-                        int fx = p->x + rx;
-                        int fy = p->y + ry;
-                        if (fx == x && fy == y) { occupied = 1; break; }
-                    }
-                }
-                if (occupied && p->y <= y) {
-                    printf("%s  " BG_RESET, color_for_type(p->type));
-                } else {
-                    int v = field[y][x];
-                    if (v) {
-                        printf("%s  " BG_RESET, color_for_type(v-1));
-                    } else {
-                        printf("  ");
-                    }
-                }
-            }
+    Frame *prev = &frames[front], *f = &frames[!front];
+
+    // 보드: 테두리 → 고정된 블록 → 떨어지는 조각 (마스크의 켜진 비트만)
+    memset(f->cells, CELL_WALL, sizeof(f->cells));
+    for (int y = 0; y < HEIGHT; ++y) memcpy(&f->cells[y + 1][1], game.color[y], WIDTH);
+    if (p) {
+        for (uint16_t m = piece_mask[p->type][p->rot]; m; m &= m - 1) {
+            int bit = __builtin_ctz(m);
+            int fx = p->x + bit % 4, fy = p->y + bit / 4;
+            if (fx >= 0 && fx < WIDTH && fy >= 0 && fy < HEIGHT) f->cells[fy + 1][fx + 1] = p->type + 1;
         }
-        // 오른쪽에 HUD (한 줄마다)
-        if (y == 0) printf("   %sTETRIS (Termux)%s\n", FG_TEXT, BG_RESET);
-        else if (y == 1) printf("   SCORE: %d\n", score);
-        else if (y == 2) printf("   LEVEL: %d\n", level);
-        else if (y == 3) printf("   LINES: %d\n", lines_cleared);
-        else if (y == 5) printf("   NEXT:\n");
-        else if (y >= 6 && y <= 9) {
-            // show next piece in 4x4 block
-            int ry = y - 6;
-            printf("   ");
-            for (int rx = 0; rx < 4; ++rx) {
-                if (block_at(nextP->type, nextP->rot, rx, ry)) {
-                    printf("%s  " BG_RESET, color_for_type(nextP->type));
-                } else printf("  ");
-            }
-            printf("\n");
+    }
+    for (int ry = 0; ry < 4; ++ry) for (int rx = 0; rx < 4; ++rx)
+        f->next[ry][rx] = block_at(nextP->type, nextP->rot, rx, ry) ? nextP->type + 1 : 0;
+
+    // 오른쪽에 HUD (필드 행마다 한 줄)
+    memset(f->hud, 0, sizeof(f->hud));
+    snprintf(f->hud[1], HUD_LEN, "%sTETRIS (Termux)%s", FG_TEXT, BG_RESET);
+    snprintf(f->hud[2], HUD_LEN, "SCORE: %d", game.score);
+    snprintf(f->hud[3], HUD_LEN, "LEVEL: %d", game.level);
+    snprintf(f->hud[4], HUD_LEN, "LINES: %d", game.lines);
+    snprintf(f->hud[6], HUD_LEN, "NEXT:");
+    snprintf(f->hud[12], HUD_LEN, "Controls:");
+    snprintf(f->hud[13], HUD_LEN, "a:left  d:right  s:down  w:rotate");
+    snprintf(f->hud[14], HUD_LEN, "space:hard drop  p:pause  q:quit");
+
+    // diff: 처음이거나 무효화된 뒤에는 모든 칸이 바뀐 것으로 본다
+    int full = !frame_valid;
+    out_row = out_col = out_color = -1;     // 다른 printf 가 커서를 옮겼을 수 있다
+    for (int r = 0; r < SCREEN_H; ++r) {
+        int row = r + 1;
+        for (int c = 0; c < SCREEN_W; ++c)
+            if (full || f->cells[r][c] != prev->cells[r][c]) out_cell(row, 2 * c + 1, f->cells[r][c]);
+        if (full || strcmp(f->hud[r], prev->hud[r]) != 0) {
+            out_goto(row, HUD_COL);
+            if (out_color != 0) out_str(BG_RESET);
+            out_str("   ");
+            out_str(f->hud[r]);
+            out_str("\033[K");                 // 이전 글자가 더 길었으면 남은 부분 지우기
+            out_row = out_col = -1;
+            out_color = 0;
+        }
+        int ry = r - 1 - NEXT_ROW;
+        if (ry >= 0 && ry < 4) {
+            for (int rx = 0; rx < 4; ++rx)
+                if (full || f->next[ry][rx] != prev->next[ry][rx])
+                    out_cell(row, HUD_COL + 3 + 2 * rx, f->next[ry][rx]);
         }
-        else if (y == 11) printf("   Controls:\n");
-        else if (y == 12) printf("   a:left  d:right  s:down  w:rotate\n");
-        else if (y == 13) printf("   space:hard drop  p:pause  q:quit\n");
-        else printf("\n");
     }
-    fflush(stdout);
+    if (out_len) {
+        if (out_color != 0) out_str(BG_RESET);
+        fflush(stdout);                     // printf 로 먼저 나간 출력과 순서를 맞춘다
+        out_flush();
+    }
+    front = !front;
+    frame_valid = 1;
 }
 
-// 하드 드롭 (즉시 내려서 고정)
-void hard_drop(Piece *p) {
-    while (!collide_piece(p->type, p->rot, p->x, p->y + 1)) p->y++;
-    merge_piece(p);
-    clear_lines_and_score();
+// 중력 주기 (ms): 기본 500ms, level이 올라갈수록 빨라짐 (레벨당 약 7%씩, 최소 50ms)
+unsigned long gravity_delay_ms(int lv) {
+    int base_delay_ms = 500;
+    int delay = base_delay_ms * (100 - (lv - 1) * 7) / 100;
+    return delay < 50 ? 50 : delay;
 }
 
 // 시그널 (예: Ctrl+C) 처리: 터미널 복구 후 종료
@@ -302,111 +659,136 @@ void sigint_handler(int signo) {
     exit(0);
 }
 
-int main() {
+// AI 가 두는 모드 (실행 인자 --ai): 조각이 나올 때마다 AI 가 고른 회전·열로 옮겨 둔다
+int ai_mode = 0;
+
+// 다음 조각 꺼내기 (나올 자리가 막히면 game over)
+void spawn_next(void) {
+    curPiece = nextPiece;
+    nextPiece = make_random_piece();
+    if (ai_mode) {
+        Placement pl = ai_choose(&game, curPiece.type, NULL);
+        if (pl.rot >= 0) { curPiece.rot = pl.rot; curPiece.x = pl.x; }
+    }
+    if (collide_piece(&game, curPiece.type, curPiece.rot, curPiece.x, curPiece.y)) game_over = 1;
+}
+
+// 실행 인자: [--ai] [--bench 조각 수 [시드]]  (--bench 는 화면 없이 AI 속도만 잰다)
+int main(int argc, char *argv[]) {
     srand(time(NULL));
-    signal(SIGINT, sigint_handler);
 
     // 초기화
-    memset(field, 0, sizeof(field));
+    init_piece_masks();
+    init_ai();
+    reset_state(&game);
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--ai") == 0) ai_mode = 1;
+        else if (strcmp(argv[i], "--bench") == 0 && i + 1 < argc) {
+            long pieces = atol(argv[++i]);
+            unsigned int seed = i + 1 < argc ? (unsigned int)atoi(argv[++i]) : (unsigned int)time(NULL);
+            run_batch(pieces > 0 ? pieces : 1, seed);
+            return 0;
+        }
+    }
+
+    signal(SIGINT, sigint_handler);
     enable_raw_mode();
     cls();
 
     nextPiece = make_random_piece();
-    curPiece = make_random_piece();
+    spawn_next();
     // if spawn collides immediately -> game over
-    if (collide_piece(curPiece.type, curPiece.rot, curPiece.x, curPiece.y)) {
+    if (game_over) {
         restore_terminal();
         printf("Cannot spawn. Terminal too small or board blocked.\n");
         return 0;
     }
 
-    // 타이머 설정: 기본 delay(마이크로초), level이 올라갈수록 빨라짐
-    int base_delay_ms = 500; // 기본 500ms
-    unsigned long last_tick = 0;
-    struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    last_tick = ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+    // 타이머: 마지막 중력 tick 시각 + gravity_delay_ms(game.level) 가 다음 마감
+    unsigned long last_tick = now_ms();
+    int dirty = 1; // 마지막으로 그린 뒤 상태가 바뀌었는가
 
     while (!game_over) {
-        // draw
-        draw_all(&curPiece, &nextPiece);
+        // draw: 바뀐 것이 있을 때만
+        if (dirty) {
+            draw_all(&curPiece, &nextPiece);
+            dirty = 0;
+        }
+
+        // 입력이나 다음 중력 마감까지 잠들기 (일시정지 중에는 입력만 기다림)
+        unsigned long deadline = last_tick + gravity_delay_ms(game.level);
+        unsigned long now = now_ms();
+        int timeout = paused ? -1 : (deadline > now ? (int)(deadline - now) : 0);
+        unsigned char keys[64];
+        int nkeys = wait_keys(timeout, keys, sizeof(keys));
+        if (nkeys < 0) game_over = 1; // 터미널이 닫힘
 
-        // input 처리 (비차단)
-        int k = read_key_nonblock();
-        if (k != -1) {
+        // input 처리
+        for (int i = 0; i < nkeys && !game_over; ++i) {
+            int k = keys[i];
+            Piece before = curPiece;
             if (k == 'a') {
-                if (!collide_piece(curPiece.type, curPiece.rot, curPiece.x - 1, curPiece.y)) curPiece.x--;
+                if (!collide_piece(&game, curPiece.type, curPiece.rot, curPiece.x - 1, curPiece.y)) curPiece.x--;
             } else if (k == 'd') {
-                if (!collide_piece(curPiece.type, curPiece.rot, curPiece.x + 1, curPiece.y)) curPiece.x++;
+                if (!collide_piece(&game, curPiece.type, curPiece.rot, curPiece.x + 1, curPiece.y)) curPiece.x++;
             } else if (k == 's') {
-                if (!collide_piece(curPiece.type, curPiece.rot, curPiece.x, curPiece.y + 1)) curPiece.y++;
+                if (!collide_piece(&game, curPiece.type, curPiece.rot, curPiece.x, curPiece.y + 1)) curPiece.y++;
             } else if (k == 'w') {
                 int nr = (curPiece.rot + 1) % 4;
-                if (!collide_piece(curPiece.type, nr, curPiece.x, curPiece.y)) curPiece.rot = nr;
+                if (!collide_piece(&game, curPiece.type, nr, curPiece.x, curPiece.y)) curPiece.rot = nr;
                 else {
                     // simple wall-kick attempt: try shift left/right
-                    if (!collide_piece(curPiece.type, nr, curPiece.x - 1, curPiece.y)) { curPiece.x--; curPiece.rot = nr; }
-                    else if (!collide_piece(curPiece.type, nr, curPiece.x + 1, curPiece.y)) { curPiece.x++; curPiece.rot = nr; }
+                    if (!collide_piece(&game, curPiece.type, nr, curPiece.x - 1, curPiece.y)) { curPiece.x--; curPiece.rot = nr; }
+                    else if (!collide_piece(&game, curPiece.type, nr, curPiece.x + 1, curPiece.y)) { curPiece.x++; curPiece.rot = nr; }
                 }
             } else if (k == ' ') {
-                hard_drop(&curPiece);
-                // spawn
-                curPiece = nextPiece;
-                nextPiece = make_random_piece();
-                if (collide_piece(curPiece.type, curPiece.rot, curPiece.x, curPiece.y)) game_over = 1;
+                hard_drop(&game, &curPiece);
+                spawn_next();
+                dirty = 1;
             } else if (k == 'p') {
                 paused = !paused;
                 if (paused) {
                     gotoxy(1, HEIGHT/2);
                     printf("==== PAUSED: Press 'p' to resume ====\n");
                 } else {
-                    // redraw immediately
+                    // redraw immediately, 중력은 다시 한 주기 뒤부터
                     cls();
+                    invalidate_frame();
+                    last_tick = now_ms();
+                    dirty = 1;
                 }
             } else if (k == 'q') {
                 game_over = 1;
             }
+            if (memcmp(&before, &curPiece, sizeof(Piece)) != 0) dirty = 1;
         }
 
         // tick: gravity
-        clock_gettime(CLOCK_MONOTONIC, &ts);
-        unsigned long now_ms = ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
-        unsigned long delay_ms = base_delay_ms;
-        // speed up by level (simple): each level reduces delay
-        if (level > 1) {
-            delay_ms = base_delay_ms * (100 - (level-1)*7) / 100; // decrease 7% per level approx
-            if (delay_ms < 50) delay_ms = 50;
-        }
-
-        if (!paused && now_ms - last_tick >= delay_ms) {
-            last_tick = now_ms;
+        now = now_ms();
+        if (!paused && now >= last_tick + gravity_delay_ms(game.level)) {
+            last_tick = now;
             // try move down
-            if (!collide_piece(curPiece.type, curPiece.rot, curPiece.x, curPiece.y + 1)) {
+            if (!collide_piece(&game, curPiece.type, curPiece.rot, curPiece.x, curPiece.y + 1)) {
                 curPiece.y++;
             } else {
                 // lock piece
-                merge_piece(&curPiece);
-                clear_lines_and_score();
+                merge_piece(&game, &curPiece);
+                clear_lines_and_score(&game, NULL);
                 // spawn next
-                curPiece = nextPiece;
-                nextPiece = make_random_piece();
-                if (collide_piece(curPiece.type, curPiece.rot, curPiece.x, curPiece.y)) {
-                    game_over = 1;
-                }
+                spawn_next();
             }
+            dirty = 1;
         }
-
-        // 소소한 대기 (너무 높은 CPU 사용을 막기 위해)
-        usleep(8000); // 8ms
     }
 
     // 종료 루틴
     cls();
     restore_terminal();
     printf("===== GAME OVER =====\n");
-    printf("Score: %d\n", score);
-    printf("Lines: %d\n", lines_cleared);
-    printf("Level: %d\n", level);
+    printf("Score: %d\n", game.score);
+    printf("Lines: %d\n", game.lines);
+    printf("Level: %d\n", game.level);
     printf("Thanks for playing!\n");
     return 0;
 }
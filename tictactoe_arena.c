@@ -0,0 +1,168 @@
+// tictactoe_arena.c
+// 틱택토 엔진끼리 사람 입력 없이 대전시키는 헤드리스 아레나
+// 실행: ./game <엔진A> <엔진B> [판 수] [스레드 수] [랜덤 오프닝 수] [시드]
+//   엔진: random, minimax, alphabeta, table
+// 예시: make FILE=tictactoe_arena ARGS="minimax alphabeta 1000000 4"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "tictactoe_engine.h"
+
+enum { ENGINE_RANDOM, ENGINE_MINIMAX, ENGINE_ALPHABETA, ENGINE_TABLE, ENGINE_COUNT };
+
+static const char *engineNames[ENGINE_COUNT] = { "random", "minimax", "alphabeta", "table" };
+
+// 결과 칸: A 승, 무승부, B 승
+enum { A_WIN, DRAW, B_WIN };
+
+// 워커 스레드 하나가 맡는 판 구간과 결과
+typedef struct {
+    long first, last;           // 판 번호 [first, last)
+    long result[2][3];          // [0: A가 X, 1: B가 X][A 승, 무, B 승]
+    long nodes;
+    pthread_t thread;
+    int started;                // 스레드를 못 만들었으면 0 (메인 스레드가 대신 돈다)
+} Shard;
+
+static int engineA, engineB, openingPlies;
+static unsigned int baseSeed;
+
+// 이름으로 엔진 번호 찾기 (없으면 -1)
+static int findEngine(const char *name) {
+    for (int i = 0; i < ENGINE_COUNT; i++)
+        if (strcmp(name, engineNames[i]) == 0)
+            return i;
+    return -1;
+}
+
+// 판 번호마다 고정된 시드 (스레드 수와 상관없이 같은 오프닝이 나오게)
+static unsigned int gameSeed(long game) {
+    unsigned long long z = baseSeed + (unsigned long long)game * 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return (unsigned int)(z ^ (z >> 31));
+}
+
+// 엔진 하나로 side 쪽 수 고르기
+static int pickMove(int engine, Board *b, char side, unsigned int *seed) {
+    switch (engine) {
+        case ENGINE_RANDOM:    return randomMove(b, seed);
+        case ENGINE_MINIMAX:   return bestMoveMinimax(b, side, NULL);
+        case ENGINE_ALPHABETA: return bestMoveAlphaBeta(b, side);
+        default:               return perfectLookup(b).cell;
+    }
+}
+
+// 한 판 진행: 승자 'X', 'O' 또는 무승부 ' '
+static char playGame(int engineX, int engineO, unsigned int seed) {
+    Board b;
+    initBoard(&b);
+
+    for (int ply = 0; ; ply++) {
+        char side = (ply & 1) ? 'O' : 'X';
+        Mask *mine = (side == 'X') ? &b.x : &b.o;
+        int cell;
+
+        if (ply < openingPlies) cell = randomMove(&b, &seed);     // 랜덤 오프닝
+        else cell = pickMove(side == 'X' ? engineX : engineO, &b, side, &seed);
+
+        *mine |= 1ull << cell;
+        if (hasLine(*mine)) return side;
+        if (isFull(&b)) return ' ';
+    }
+}
+
+// 워커: 짝수 판은 A가 X, 홀수 판은 B가 X (선공 교대)
+static void *runShard(void *arg) {
+    Shard *s = arg;
+    resetSearchStats();
+
+    for (long g = s->first; g < s->last; g++) {
+        int bIsX = (int)(g & 1);
+        char winner = bIsX ? playGame(engineB, engineA, gameSeed(g))
+                           : playGame(engineA, engineB, gameSeed(g));
+        int outcome = DRAW;
+        if (winner != ' ')
+            outcome = ((winner == 'X') != bIsX) ? A_WIN : B_WIN;
+        s->result[bIsX][outcome]++;
+    }
+
+    s->nodes = searchNodes;
+    return NULL;
+}
+
+static void usage(void) {
+    printf("사용법: ./game <엔진A> <엔진B> [판 수] [스레드 수] [랜덤 오프닝 수] [시드]\n");
+    printf("엔진: random, minimax, alphabeta, table\n");
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        usage();
+        return 1;
+    }
+    engineA = findEngine(argv[1]);
+    engineB = findEngine(argv[2]);
+    if (engineA < 0 || engineB < 0) {
+        printf("❌ 알 수 없는 엔진입니다.\n");
+        usage();
+        return 1;
+    }
+
+    long games = argc > 3 ? atol(argv[3]) : 100000;
+    int threads = argc > 4 ? atoi(argv[4]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    openingPlies = argc > 5 ? atoi(argv[5]) : 2;
+    baseSeed = argc > 6 ? (unsigned int)strtoul(argv[6], NULL, 10) : (unsigned int)time(NULL);
+    if (games < 1) games = 1;
+    if (threads < 1) threads = 1;
+    if (openingPlies < 0) openingPlies = 0;
+
+    initGeometry(3, 3, 3);
+    initPerfectTable();
+
+    printf("🏟️  %s vs %s | %ld판, 스레드 %d개, 랜덤 오프닝 %d수, 시드 %u\n",
+           engineNames[engineA], engineNames[engineB], games, threads, openingPlies, baseSeed);
+
+    Shard *shards = calloc((size_t)threads, sizeof(Shard));
+    double start = nowMs();
+    for (int t = 0; t < threads; t++) {
+        shards[t].first = games * t / threads;
+        shards[t].last = games * (t + 1) / threads;
+        shards[t].started = pthread_create(&shards[t].thread, NULL, runShard, &shards[t]) == 0;
+    }
+
+    // 만들지 못한 스레드 몫은 빠뜨리지 않고 여기서 직접 돌린다
+    for (int t = 0; t < threads; t++) {
+        if (shards[t].started) continue;
+        printf("⚠️  스레드 %d을(를) 만들 수 없어 메인 스레드에서 돌립니다.\n", t);
+        runShard(&shards[t]);
+    }
+
+    long result[2][3] = {{0}}, nodes = 0;
+    for (int t = 0; t < threads; t++) {
+        if (shards[t].started) pthread_join(shards[t].thread, NULL);
+        for (int c = 0; c < 2; c++)
+            for (int o = 0; o < 3; o++)
+                result[c][o] += shards[t].result[c][o];
+        nodes += shards[t].nodes;
+    }
+    double elapsed = (nowMs() - start) / 1000.0;
+    free(shards);
+
+    // 승/무/패 표 (A 기준)
+    printf("\n%-24s %10s %10s %10s\n", "", "A 승", "무", "B 승");
+    printf("%-24s %10ld %10ld %10ld\n", "A=X, B=O", result[0][A_WIN], result[0][DRAW], result[0][B_WIN]);
+    printf("%-24s %10ld %10ld %10ld\n", "B=X, A=O", result[1][A_WIN], result[1][DRAW], result[1][B_WIN]);
+    printf("%-24s %10ld %10ld %10ld\n", "합계",
+           result[0][A_WIN] + result[1][A_WIN], result[0][DRAW] + result[1][DRAW],
+           result[0][B_WIN] + result[1][B_WIN]);
+
+    printf("\n⏱️  %.3f초 | %.0f games/sec | 노드 %ld개, %.0f nodes/sec\n",
+           elapsed, games / elapsed, nodes, nodes / elapsed);
+    return 0;
+}
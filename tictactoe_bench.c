@@ -0,0 +1,180 @@
+// tictactoe_bench.c
+// 고정된 국면 모음으로 틱택토 엔진 성능을 재는 벤치마크
+// 실행: ./game [--json] [--repeat N]
+//   --json   : 결과를 JSON 으로 출력 (리비전 사이 비교용)
+//   --repeat : 국면마다 N번 재서 가장 빠른 시간을 쓴다 (기본 3)
+// 예시: make bench ARGS="--json"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tictactoe_engine.h"
+
+// 벤치마크 국면: 보드 형태, 칸 문자열(행 우선, X/O/.), 알파베타 깊이 제한
+// 둘 차례는 X, O 개수로 정한다 (X가 먼저 둔다)
+typedef struct {
+    const char *name;
+    int rows, cols, k;
+    const char *cells;
+    int depth;
+} BenchPosition;
+
+static const BenchPosition suite[] = {
+    { "3x3-empty",       3, 3, 3, ".........", 8 },
+    { "3x3-corner",      3, 3, 3, "X........", 8 },
+    { "3x3-fork",        3, 3, 3, "X...O...X", 8 },
+    { "4x4k3-opening",   4, 4, 3, ".....X....O.....", 8 },
+    { "4x4k4-middle",    4, 4, 4, "X..O.XO...O....X", 9 },
+    { "5x5k4-opening",   5, 5, 4, "............X............", 6 },
+    { "6x7k4-empty",     6, 7, 4, "..........................................", 6 },
+    { "6x7k4-middle",    6, 7, 4, "..........................O.X...XO.X..OXO.", 7 },
+    { "7x7k5-opening",   7, 7, 5, "........................X........................", 5 },
+    { "8x8k5-middle",    8, 8, 5, "...........................OX......XO...........................", 4 },
+};
+
+#define SUITE_SIZE (int)(sizeof(suite) / sizeof(suite[0]))
+#define MINIMAX_MAX_EMPTY 10        // minimax 는 끝까지 읽으므로 빈 칸이 이보다 많으면 건너뛴다
+#define EVAL_CALLS 200000           // 평가 함수 벤치마크 호출 횟수
+
+// 엔진 하나를 한 국면에서 잰 결과
+typedef struct {
+    const char *position;
+    const char *engine;
+    int depth;
+    long nodes;
+    double ms;
+    int move;                   // 평가 함수는 수를 고르지 않으므로 -1
+    int score;
+} BenchResult;
+
+static BenchResult results[SUITE_SIZE * 3];
+static int resultCount;
+
+// 칸 문자열로 보드 채우기, 둘 차례('X' / 'O')를 돌려준다
+static char loadPosition(const BenchPosition *pos, Board *b) {
+    initBoard(b);
+    int xs = 0, os = 0;
+    for (int cell = 0; cell < CELLS; cell++) {
+        if (pos->cells[cell] == 'X') { b->x |= 1ull << cell; xs++; }
+        if (pos->cells[cell] == 'O') { b->o |= 1ull << cell; os++; }
+    }
+    return xs > os ? 'O' : 'X';
+}
+
+// 매 측정마다 전치표와 수 정렬 상태를 비워 같은 조건에서 시작한다
+static void coldStart(void) {
+    ttClear();
+    clearMoveOrdering();
+    resetSearchStats();
+}
+
+// 📘 minimax: 끝까지 읽는 기준 엔진 (점수는 엔진 루트가 돌려준 고른 수의 minimax 값)
+static int runMinimax(Board *b, char side, int *score) {
+    coldStart();
+    return bestMoveMinimax(b, side, score);
+}
+
+// 📘 알파베타: 고정 깊이 (시간 제한 없음)
+static int runAlphaBeta(Board *b, char side, int depth, int *score) {
+    coldStart();
+    return searchRootAlphaBeta(b, side, depth - 1, -1, score);
+}
+
+// 📘 평가 함수만 반복 호출 (노드 수 = 호출 수)
+static int runEvaluate(Board *b, int *score) {
+    coldStart();
+    int sum = 0;
+    for (int i = 0; i < EVAL_CALLS; i++) {
+        __asm__ volatile("" : : "r"(b) : "memory");     // 호출이 반복문 밖으로 빠지지 않게
+        sum += evaluateHeuristic(b, i & 7);
+    }
+    searchNodes = EVAL_CALLS;
+    *score = sum / EVAL_CALLS;
+    return -1;
+}
+
+// 같은 측정을 repeat 번 하고 가장 빠른 시간을 기록
+static void measure(const BenchPosition *pos, const char *engine, int depth, int repeat) {
+    BenchResult *r = &results[resultCount++];
+    r->position = pos->name;
+    r->engine = engine;
+    r->depth = depth;
+    r->ms = -1;
+
+    for (int t = 0; t < repeat; t++) {
+        Board b;
+        char side = loadPosition(pos, &b);
+        double start = nowMs();
+        if (strcmp(engine, "minimax") == 0) r->move = runMinimax(&b, side, &r->score);
+        else if (strcmp(engine, "alphabeta") == 0) r->move = runAlphaBeta(&b, side, depth, &r->score);
+        else r->move = runEvaluate(&b, &r->score);
+        double ms = nowMs() - start;
+
+        if (r->ms < 0 || ms < r->ms) r->ms = ms;
+        r->nodes = searchNodes;
+    }
+}
+
+static void printTable(void) {
+    printf("%-16s %-10s %5s %12s %10s %14s %6s\n", "국면", "엔진", "깊이", "노드", "ms", "nodes/sec", "수");
+    long totalNodes = 0;
+    double totalMs = 0;
+    for (int i = 0; i < resultCount; i++) {
+        const BenchResult *r = &results[i];
+        char move[12] = "-";
+        if (r->move >= 0) snprintf(move, sizeof(move), "%d", r->move);
+        printf("%-16s %-10s %5d %12ld %10.2f %14.0f %6s\n", r->position, r->engine, r->depth,
+               r->nodes, r->ms, r->nodes / (r->ms > 0 ? r->ms / 1000.0 : 1e-6), move);
+        totalNodes += r->nodes;
+        totalMs += r->ms;
+    }
+    printf("\n⏱️  합계 %.2fms | 노드 %ld개, %.0f nodes/sec\n",
+           totalMs, totalNodes, totalNodes / (totalMs > 0 ? totalMs / 1000.0 : 1e-6));
+}
+
+static void printJson(void) {
+    printf("{\n  \"results\": [\n");
+    for (int i = 0; i < resultCount; i++) {
+        const BenchResult *r = &results[i];
+        printf("    {\"position\": \"%s\", \"engine\": \"%s\", \"depth\": %d, \"nodes\": %ld, "
+               "\"ms\": %.3f, \"nps\": %.0f, \"move\": %d, \"score\": %d}%s\n",
+               r->position, r->engine, r->depth, r->nodes, r->ms,
+               r->nodes / (r->ms > 0 ? r->ms / 1000.0 : 1e-6), r->move, r->score,
+               i + 1 < resultCount ? "," : "");
+    }
+    printf("  ]\n}\n");
+}
+
+int main(int argc, char *argv[]) {
+    int json = 0, repeat = 3;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0) json = 1;
+        else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) repeat = atoi(argv[++i]);
+        else {
+            printf("사용법: ./game [--json] [--repeat N]\n");
+            return 1;
+        }
+    }
+    if (repeat < 1) repeat = 1;
+
+    for (int p = 0; p < SUITE_SIZE; p++) {
+        const BenchPosition *pos = &suite[p];
+        initGeometry(pos->rows, pos->cols, pos->k);
+        if ((int)strlen(pos->cells) != CELLS) {
+            fprintf(stderr, "❌ 국면 %s 의 칸 수가 보드와 맞지 않습니다.\n", pos->name);
+            return 1;
+        }
+
+        Board b;
+        loadPosition(pos, &b);
+        if (__builtin_popcountll(emptyMask(&b)) <= MINIMAX_MAX_EMPTY)
+            measure(pos, "minimax", __builtin_popcountll(emptyMask(&b)), repeat);
+        measure(pos, "alphabeta", pos->depth, repeat);
+        measure(pos, "evaluate", 0, repeat);
+    }
+
+    if (json) printJson();
+    else printTable();
+    return 0;
+}
@@ -0,0 +1,1069 @@
+// tictactoe_engine.h
+// 틱택토 엔진 공용 코어 (tictactoe.c, tictactoe_heuristic.c, tictactoe_arena.c 에서 include)
+// m x n 보드에서 k개를 잇는 게임(m,n,k)을 다룬다. 기본은 3 x 3, k = 3
+// 보드는 X, O 각각 64비트 마스크로 표현한다. 비트 번호 = 행 * COLS + 열
+
+#ifndef TICTACTOE_ENGINE_H
+#define TICTACTOE_ENGINE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#define MAX_CELLS 64        // 마스크 한 개에 들어가는 칸 수
+#define MAX_LINES (4 * MAX_CELLS)
+
+typedef unsigned long long Mask;
+
+// 비트보드: 플레이어(X)와 컴퓨터(O)의 마스크
+typedef struct {
+    Mask x;
+    Mask o;
+} Board;
+
+// ───────── 보드 형태 (실행 중 한 번 정함) ─────────
+
+static int ROWS = 3, COLS = 3, KWIN = 3;
+static int CELLS = 9;
+static Mask FULL_MASK = 0x1FF;          // 모든 칸이 찬 상태
+
+// k칸 승리 라인 마스크 (평가 함수용)
+static Mask lineMasks[MAX_LINES];
+static int lineCount;
+
+// 칸마다 그 칸을 지나는 라인 번호 목록: cellLineList[cellLineStart[c] .. cellLineStart[c + 1])
+static int cellLineStart[MAX_CELLS + 1];
+static unsigned short cellLineList[MAX_LINES * MAX_CELLS];
+
+// 칸의 기본 가치 = 그 칸을 지나는 라인 수 (3x3 에서는 중앙 4, 모서리 3, 변 2)
+static int cellWeight[MAX_CELLS];
+
+// 방향별 시프트 양과 "여기서 k칸이 들어가는 시작 칸" 마스크 (가로, 세로, 대각선 2개)
+static int dirShift[4];
+static Mask dirStart[4];
+
+// 대칭: 칸 번호 변환 + 8비트 조각별 마스크 변환 표
+static int symCount;
+static int symCell[8][MAX_CELLS];
+static int symInv[8][MAX_CELLS];        // symCell 의 역변환
+static Mask symChunk[8][MAX_CELLS / 8][256];
+
+// s번째 대칭으로 옮긴 칸 (s & 4: 좌우 반전, s & 3: 시계 방향 90도 회전 횟수)
+static inline int mapCell(int s, int cell) {
+    int r = cell / COLS, c = cell % COLS;
+    if (s & 4) c = COLS - 1 - c;
+    for (int k = 0; k < (s & 3); k++) {     // 정사각형 보드에서만 90도 회전을 쓴다
+        int tmp = r;
+        r = c;
+        c = ROWS - 1 - tmp;
+    }
+    return r * COLS + c;
+}
+
+// 보드 형태 초기화: 라인, 방향 마스크, 대칭 표 (잘못된 크기면 0)
+static inline int initGeometry(int rows, int cols, int k) {
+    if (rows < 3 || cols < 3 || rows * cols > MAX_CELLS) return 0;
+    if (k < 3 || (k > rows && k > cols)) return 0;
+
+    ROWS = rows;
+    COLS = cols;
+    KWIN = k;
+    CELLS = rows * cols;
+    FULL_MASK = (CELLS == 64) ? ~0ull : (1ull << CELLS) - 1;
+
+    // 방향: (행 변화, 열 변화)
+    static const int dr[4] = { 0, 1, 1, 1 };
+    static const int dc[4] = { 1, 0, 1, -1 };
+    lineCount = 0;
+    for (int d = 0; d < 4; d++) {
+        dirShift[d] = dr[d] * COLS + dc[d];
+        dirStart[d] = 0;
+        for (int r = 0; r < ROWS; r++) {
+            for (int c = 0; c < COLS; c++) {
+                int er = r + dr[d] * (k - 1), ec = c + dc[d] * (k - 1);
+                if (er < 0 || er >= ROWS || ec < 0 || ec >= COLS) continue;
+                Mask line = 0;
+                for (int i = 0; i < k; i++)
+                    line |= 1ull << ((r + dr[d] * i) * COLS + c + dc[d] * i);
+                lineMasks[lineCount++] = line;
+                dirStart[d] |= 1ull << (r * COLS + c);
+            }
+        }
+    }
+
+    // 칸별 라인 목록
+    int used = 0;
+    for (int cell = 0; cell < CELLS; cell++) {
+        cellLineStart[cell] = used;
+        for (int i = 0; i < lineCount; i++)
+            if (lineMasks[i] & (1ull << cell))
+                cellLineList[used++] = (unsigned short)i;
+        cellWeight[cell] = used - cellLineStart[cell];
+    }
+    cellLineStart[CELLS] = used;
+
+    // 정사각형은 8가지, 직사각형은 4가지(회전 0, 180도 × 좌우 반전)
+    static const int squareSyms[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+    static const int rectSyms[4] = { 0, 2, 4, 6 };
+    const int *syms = (ROWS == COLS) ? squareSyms : rectSyms;
+    symCount = (ROWS == COLS) ? 8 : 4;
+    for (int i = 0; i < symCount; i++) {
+        for (int cell = 0; cell < CELLS; cell++) {
+            int s = syms[i];
+            if (ROWS != COLS && (s & 3) == 2) {
+                int r = cell / COLS, c = cell % COLS;     // 직사각형의 180도 회전
+                if (s & 4) c = COLS - 1 - c;
+                symCell[i][cell] = (ROWS - 1 - r) * COLS + (COLS - 1 - c);
+            } else {
+                symCell[i][cell] = mapCell(s, cell);
+            }
+            symInv[i][symCell[i][cell]] = cell;
+        }
+        for (int chunk = 0; chunk < MAX_CELLS / 8; chunk++) {
+            for (int v = 0; v < 256; v++) {
+                Mask t = 0;
+                for (int bit = 0; bit < 8; bit++) {
+                    int cell = chunk * 8 + bit;
+                    if ((v & (1 << bit)) && cell < CELLS)
+                        t |= 1ull << symCell[i][cell];
+                }
+                symChunk[i][chunk][v] = t;
+            }
+        }
+    }
+    return 1;
+}
+
+// 빈 보드로 초기화
+static inline void initBoard(Board *b) {
+    b->x = 0;
+    b->o = 0;
+}
+
+// 마스크 하나가 k칸 라인을 완성했는지 검사 (방향마다 시프트 k-1번)
+static inline int hasLine(Mask m) {
+    for (int d = 0; d < 4; d++) {
+        Mask run = m & dirStart[d];
+        for (int i = 1; i < KWIN && run; i++)
+            run &= m >> (i * dirShift[d]);
+        if (run) return 1;
+    }
+    return 0;
+}
+
+// 승자 판별 함수 ('X', 'O', 승자 없으면 ' ')
+static inline char checkWin(const Board *b) {
+    if (hasLine(b->x)) return 'X';
+    if (hasLine(b->o)) return 'O';
+    return ' ';
+}
+
+// 보드가 가득 찼는지 확인 (비교 한 번)
+static inline int isFull(const Board *b) {
+    return (b->x | b->o) == FULL_MASK;
+}
+
+// 빈 칸 마스크 (낮은 비트부터 = 행 우선 순서)
+static inline Mask emptyMask(const Board *b) {
+    return ~(b->x | b->o) & FULL_MASK;
+}
+
+// (행, 열) 칸의 문자
+static inline char cellAt(const Board *b, int row, int col) {
+    Mask bit = 1ull << (row * COLS + col);
+    if (b->x & bit) return 'X';
+    if (b->o & bit) return 'O';
+    return ' ';
+}
+
+// (행, 열) 칸에 수 두기
+static inline void placeMark(Board *b, int row, int col, char player) {
+    Mask bit = 1ull << (row * COLS + col);
+    if (player == 'X') b->x |= bit;
+    else b->o |= bit;
+}
+
+// 밀리초 단위 단조 시계
+static inline double nowMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+// ───────── 대칭 + 전치표 ─────────
+
+// s번째 대칭으로 옮긴 마스크 (8비트 조각 표를 OR)
+static inline Mask symApply(int s, Mask m) {
+    Mask t = 0;
+    for (int chunk = 0; m; chunk++, m >>= 8)
+        t |= symChunk[s][chunk][m & 0xFF];
+    return t;
+}
+
+// 대칭을 하나로 묶은 정규화 키: 모든 대칭 중 (o, x)가 가장 작은 것을 64비트로 섞는다
+// symOut 에는 정규화에 쓴 대칭 번호를 돌려준다 (전치표의 최선 수를 실제 칸으로 되돌릴 때)
+static inline unsigned long long canonicalKey(const Board *b, int isMaximizing, int *symOut) {
+    Mask bx = b->x, bo = b->o;
+    int sym = 0;
+    for (int s = 1; s < symCount; s++) {
+        Mask tx = symApply(s, b->x), to = symApply(s, b->o);
+        if (to < bo || (to == bo && tx < bx)) {
+            bx = tx;
+            bo = to;
+            sym = s;
+        }
+    }
+    if (symOut) *symOut = sym;
+    unsigned long long h = bx * 0x9E3779B97F4A7C15ull ^ (bo + 0x632BE59BD9B4E019ull) * 0xC2B2AE3D27D4EB4Full;
+    h ^= h >> 29;
+    h *= 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 32;
+    return isMaximizing ? ~h : h;
+}
+
+// 두 엔진은 점수 척도가 달라 같은 전치표를 쓸 때 키에 엔진 표시를 섞는다
+#define TT_TAG_MINIMAX   0ull
+#define TT_TAG_ALPHABETA 0x5851F42D4C957F2Dull
+
+#define TT_BITS 16
+#define TT_SIZE (1 << TT_BITS)
+
+// 전치표 항목 종류 (0 = 빈 칸)
+enum { TT_EXACT = 1, TT_LOWER, TT_UPPER };
+
+typedef struct {
+    short value;
+    unsigned char flag;
+    unsigned char draft;        // 이 값을 얻을 때 남아 있던 탐색 깊이
+    signed char move;           // 정규화된 보드 기준 최선 수 (없으면 -1)
+} TTEntry;
+
+// 실제 저장 칸: 항목을 64비트 하나(data)로 묶고 check = key ^ data 로 둔다.
+// 여러 스레드가 락 없이 같이 써도, 두 워드가 서로 다른 쓰기에서 왔으면 키 검사에서 걸러진다.
+typedef struct {
+    unsigned long long check;
+    unsigned long long data;
+} TTSlot;
+
+// 전치표는 기본적으로 스레드마다 따로 둔다 (대전 모드의 워커 스레드용).
+// 병렬 탐색 중에는 ttShared 가 가리키는 공용 표를 모든 탐색 스레드가 같이 쓴다.
+static _Thread_local TTSlot ttLocal[TT_SIZE];
+static _Thread_local TTSlot *ttShared;
+
+static inline TTSlot *ttSlot(unsigned long long key) {
+    return (ttShared ? ttShared : ttLocal) + (key >> (64 - TT_BITS));
+}
+
+// 📘 지금 스레드가 쓰는 전치표 (다른 스레드에 ttShared 로 넘겨 같은 표를 쓰게 할 때)
+static inline TTSlot *currentTable(void) {
+    return ttShared ? ttShared : ttLocal;
+}
+
+// 탐색 통계
+static _Thread_local long searchNodes, ttHits, ttMisses;
+static _Thread_local long betaCutoffs, firstMoveCutoffs;   // 가지치기 수, 그중 첫 수에서 난 것
+
+// 📘 상세 탐색 계측 (컴파일 옵션 -DTTT_STATS 일 때만, 끄면 코드가 아예 빠진다)
+// 깊이(루트 수 다음부터 1)별 노드, 가지치기가 난 수의 순번, 종단 국면, 루트 수별 시간
+// 예시: make FILE=tictactoe_heuristic CFLAGS="-Wall -O2 -DTTT_STATS"
+#ifdef TTT_STATS
+typedef struct {
+    long nodesAtDepth[MAX_CELLS + 2];
+    long cutoffAtIndex[MAX_CELLS];      // 몇 번째로 읽은 수에서 가지치기가 났는지
+    long terminalHits;                  // 승패/무승부로 끝난 국면
+    long horizonHits;                   // 깊이 제한에서 평가로 끝난 국면
+    long expandedNodes;                 // 자식을 실제로 펼친 노드 (유효 분기 계수 계산용)
+    double rootMoveMs[MAX_CELLS];       // 칸별 루트 수 탐색 시간 (반복 심화면 모든 반복의 합)
+} SearchStats;
+
+static _Thread_local SearchStats searchStats;
+
+#define STATS(stmt) do { stmt; } while (0)
+#define STATS_TIMER(name) double name = nowMs()
+
+// 다른 스레드의 통계를 더한다 (병렬 탐색에서 호출 스레드로 모을 때)
+static inline void mergeSearchStats(SearchStats *into, const SearchStats *from) {
+    for (int d = 0; d < MAX_CELLS + 2; d++) into->nodesAtDepth[d] += from->nodesAtDepth[d];
+    for (int i = 0; i < MAX_CELLS; i++) {
+        into->cutoffAtIndex[i] += from->cutoffAtIndex[i];
+        into->rootMoveMs[i] += from->rootMoveMs[i];
+    }
+    into->terminalHits += from->terminalHits;
+    into->horizonHits += from->horizonHits;
+    into->expandedNodes += from->expandedNodes;
+}
+#else
+#define STATS(stmt) ((void)0)
+#define STATS_TIMER(name) ((void)0)
+#endif
+
+static inline void resetSearchStats(void) {
+    searchNodes = ttHits = ttMisses = 0;
+    betaCutoffs = firstMoveCutoffs = 0;
+    STATS(memset(&searchStats, 0, sizeof(searchStats)));
+}
+
+// 전치표 비우기 (벤치마크처럼 매번 같은 조건에서 탐색할 때)
+static inline void ttClear(void) {
+    memset(ttShared ? ttShared : ttLocal, 0, TT_SIZE * sizeof(TTSlot));
+}
+
+// 전치표 조회: 같은 키가 있으면 *out 에 항목을 풀어 넣고 1, 없으면 0
+static inline int ttProbe(unsigned long long key, TTEntry *out) {
+    TTSlot *slot = ttSlot(key);
+    unsigned long long data = __atomic_load_n(&slot->data, __ATOMIC_RELAXED);
+    unsigned long long check = __atomic_load_n(&slot->check, __ATOMIC_RELAXED);
+    if ((data >> 16 & 0xFF) && (check ^ data) == key) {
+        out->value = (short)(data & 0xFFFF);
+        out->flag = (unsigned char)(data >> 16);
+        out->draft = (unsigned char)(data >> 24);
+        out->move = (signed char)(data >> 32);
+        ttHits++;
+        return 1;
+    }
+    ttMisses++;
+    return 0;
+}
+
+// 전치표 저장 (항상 덮어쓰기)
+static inline void ttStore(unsigned long long key, int value, int flag, int draft, int move) {
+    TTSlot *slot = ttSlot(key);
+    unsigned long long data = (unsigned long long)(unsigned short)value
+                            | (unsigned long long)flag << 16
+                            | (unsigned long long)(draft > 255 ? 255 : draft) << 24
+                            | (unsigned long long)(unsigned char)move << 32;
+    __atomic_store_n(&slot->check, key ^ data, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->data, data, __ATOMIC_RELAXED);
+}
+
+// 승패 점수는 "루트로부터의 깊이"가 섞여 있으므로 노드 기준으로 바꿔 저장한다.
+// |score| >= winScore - CELLS 인 점수만 승패 점수로 본다.
+static inline int scoreToTT(int score, int depth, int winScore) {
+    if (score >= winScore - CELLS) return score + depth;
+    if (score <= CELLS - winScore) return score - depth;
+    return score;
+}
+
+static inline int scoreFromTT(int value, int depth, int winScore) {
+    if (value >= winScore - CELLS) return value - depth;
+    if (value <= CELLS - winScore) return value + depth;
+    return value;
+}
+
+// 탐색 통계 한 줄 출력
+static inline void printSearchStats(void) {
+    printf("📊 탐색 노드 %ld개 | 전치표 적중 %ld, 미스 %ld", searchNodes, ttHits, ttMisses);
+    if (betaCutoffs)
+        printf(" | 가지치기 %ld회 (첫 수에서 %.1f%%)", betaCutoffs, 100.0 * firstMoveCutoffs / betaCutoffs);
+    printf("\n");
+}
+
+// 📘 계측 한 줄 출력 (TTT_STATS 가 없으면 아무것도 하지 않는다)
+static inline void printSearchLog(void) {
+#ifdef TTT_STATS
+    const SearchStats *st = &searchStats;
+    printf("🧪 깊이별 노드");
+    for (int d = 1; d < MAX_CELLS + 2 && st->nodesAtDepth[d]; d++)
+        printf(" %ld", st->nodesAtDepth[d]);
+
+    long later = 0;
+    for (int i = 2; i < MAX_CELLS; i++) later += st->cutoffAtIndex[i];
+    printf(" | 컷 순번 1번 %ld, 2번 %ld, 3번 이후 %ld", st->cutoffAtIndex[0], st->cutoffAtIndex[1], later);
+    printf(" | 종단 %ld, 깊이 제한 %ld", st->terminalHits, st->horizonHits);
+    if (st->expandedNodes)
+        printf(" | EBF %.2f", (double)(searchNodes - st->nodesAtDepth[1]) / st->expandedNodes);
+
+    printf(" | 루트 수 ms");
+    for (int cell = 0; cell < CELLS; cell++)
+        if (st->rootMoveMs[cell] > 0)
+            printf(" (%d,%d)=%.1f", cell / COLS + 1, cell % COLS + 1, st->rootMoveMs[cell]);
+    printf("\n");
+#endif
+}
+
+// ───────── 3x3 완전 해 테이블 ─────────
+// 도달 가능한 모든 국면(약 5,478개)을 시작할 때 한 번 풀어 두고,
+// findBestMove 는 3진수 코드(빈칸 0, X 1, O 2)로 O(1) 조회만 한다.
+
+#define CODE_COUNT 19683    // 3^9
+
+// 최선 수(칸 번호, 둘 곳이 없으면 -1)와 게임 이론 값
+// 값은 O 기준이며 minimax 와 같은 척도(승리 10 - 깊이, 패배 깊이 - 10, 무승부 0)
+typedef struct {
+    signed char cell;
+    signed char value;
+} PerfectEntry;
+
+static PerfectEntry perfectTable[CODE_COUNT];
+static unsigned char perfectSolved[CODE_COUNT];
+static unsigned short ternary[512];             // 9비트 마스크 → 3진수 자리값의 합
+static int perfectPositions;                    // 풀어 둔 국면 수
+
+static inline int boardCode(const Board *b) {
+    return ternary[b->x] + 2 * ternary[b->o];
+}
+
+// 국면 하나를 풀고 테이블에 기록 (둘 차례는 돌 개수로 정해짐: X 선공)
+static inline int solvePerfect(Board *b) {
+    int code = boardCode(b);
+    if (perfectSolved[code]) return perfectTable[code].value;
+
+    int oToMove = __builtin_popcountll(b->x) > __builtin_popcountll(b->o);
+    int best = oToMove ? -1000 : 1000, bestCell = -1;
+
+    for (Mask empty = emptyMask(b); empty; empty &= empty - 1) {
+        Mask bit = empty & -empty;
+        Mask *mine = oToMove ? &b->o : &b->x;
+        int score;
+
+        *mine |= bit;
+        if (hasLine(*mine)) score = oToMove ? 10 : -10;
+        else if (isFull(b)) score = 0;
+        else {
+            // 한 수 더 깊어지므로 승패 점수를 0 쪽으로 1 당긴다
+            score = solvePerfect(b);
+            if (score > 0) score--;
+            else if (score < 0) score++;
+        }
+        *mine ^= bit;
+
+        if (oToMove ? score > best : score < best) {
+            best = score;
+            bestCell = __builtin_ctzll(bit);
+        }
+    }
+
+    perfectSolved[code] = 1;
+    perfectTable[code].cell = (signed char)bestCell;
+    perfectTable[code].value = (signed char)best;
+    perfectPositions++;
+    return perfectTable[code].value;
+}
+
+// 테이블 생성 (프로그램 시작 시 한 번, 3 x 3 / k = 3 에서만 가능하면 1)
+static inline int initPerfectTable(void) {
+    if (ROWS != 3 || COLS != 3 || KWIN != 3) return 0;
+    for (int m = 0; m < 512; m++) {
+        int v = 0, p = 1;
+        for (int cell = 0; cell < 9; cell++, p *= 3)
+            if (m & (1 << cell)) v += p;
+        ternary[m] = (unsigned short)v;
+    }
+    Board empty;
+    initBoard(&empty);
+    solvePerfect(&empty);
+    return 1;
+}
+
+// O(1) 조회: 둘 차례 쪽의 최선 수와 값
+static inline PerfectEntry perfectLookup(const Board *b) {
+    return perfectTable[boardCode(b)];
+}
+
+// ───────── minimax 엔진 (가지치기 없음) ─────────
+
+//점수 평가 함수 (승리 점수 CELLS + 1 - 깊이: 3x3 에서는 10 - 깊이)
+static inline int evaluate(const Board *board, int depth)
+{
+    if (hasLine(board->o)) return CELLS + 1 - depth;
+    if (hasLine(board->x)) return depth - CELLS - 1;
+    return 0;
+}
+
+//minimax 함수 (비트보드 위에서 직접 탐색)
+static inline int minimax(Board *board, int depth, int isMaximizing)
+{
+    searchNodes++;
+    STATS(searchStats.nodesAtDepth[depth + 1]++);
+    int score = evaluate(board, depth);
+
+    //게임이 끝난 경우(승패 또는 무승부)
+    if (score != 0 || isFull(board))
+    {
+        STATS(searchStats.terminalHits++);
+        return score;
+    }
+
+    //전치표 조회 (대칭을 하나로 묶은 키)
+    unsigned long long key = canonicalKey(board, isMaximizing, NULL) ^ TT_TAG_MINIMAX;
+    TTEntry entry;
+    if (ttProbe(key, &entry))
+        return scoreFromTT(entry.value, depth, CELLS + 1);
+
+    int best;
+    STATS(searchStats.expandedNodes++);
+
+    //AI 차례 (isMaximizing == 1)
+    if (isMaximizing)
+    {
+        best = -1000;
+
+        //빈 칸 비트를 하나씩 꺼내며 탐색 (낮은 비트 = 행 우선 순서)
+        for (Mask empty = emptyMask(board); empty; empty &= empty - 1)
+        {
+            Mask bit = empty & -empty;
+            board->o |= bit;  //AI 수 두기
+            int val = minimax(board, depth+1, 0);
+            board->o ^= bit; //원상 복구
+
+            if (val > best)
+                best = val;
+        }
+    }
+    //플레이어 차례 (isMaximizing == 0)
+    else
+    {
+        best = 1000;
+        for (Mask empty = emptyMask(board); empty; empty &= empty - 1)
+        {
+            Mask bit = empty & -empty;
+            board->x |= bit;  //플레이어 수 두기
+            int val = minimax(board, depth +1, 1);
+            board->x ^= bit;  //원상 복구
+
+            if (val < best)
+                best = val;
+        }
+    }
+
+    //minimax 값은 항상 끝까지 읽은 정확한 값이므로 EXACT로 저장
+    ttStore(key, scoreToTT(best, depth, CELLS + 1), TT_EXACT, CELLS, -1);
+    return best;
+}
+
+//루트 탐색: side('X' 또는 'O') 쪽의 최선 수 칸 번호 (O는 최대화, X는 최소화)
+//scoreOut 이 있으면 그 수의 minimax 값 (CELLS + 1 - 깊이 척도)을 적는다
+static inline int bestMoveMinimax(Board *board, char side, int *scoreOut)
+{
+    int oTurn = (side == 'O');
+    int best = oTurn ? -1000 : 1000, bestCell = -1;
+    Mask *mine = oTurn ? &board->o : &board->x;
+
+    for (Mask empty = emptyMask(board); empty; empty &= empty - 1)
+    {
+        Mask bit = empty & -empty;
+        STATS_TIMER(moveStart);
+        *mine |= bit;   //임시로 수 두기
+        int moveScore = minimax(board, 0, !oTurn);
+        *mine ^= bit;
+        STATS(searchStats.rootMoveMs[__builtin_ctzll(bit)] += nowMs() - moveStart);
+
+        if (oTurn ? moveScore > best : moveScore < best)
+        {
+            best = moveScore;
+            bestCell = __builtin_ctzll(bit);
+        }
+    }
+    if (scoreOut) *scoreOut = best;
+    return bestCell;
+}
+
+// ───────── 알파베타 엔진 (휴리스틱 평가) ─────────
+
+#define WIN_SCORE 10000     // 승리 점수 (라인 평가 합보다 항상 크다)
+#define INF_SCORE 30000
+
+// 깊이 제한과 시간 예산 (반복 심화용, 스레드마다 따로)
+static _Thread_local int searchDepthLimit = MAX_CELLS;
+static _Thread_local double searchDeadline;     // 0 이면 시간 제한 없음
+static _Thread_local int searchAborted;
+
+// 탐색 중단 요청: 다른 스레드가 세우면 돌고 있는 모든 탐색이 다음 확인 때 멈춘다 (생각 미리 하기 중단용)
+static int searchStop;
+
+static inline void requestSearchStop(int stop) {
+    __atomic_store_n(&searchStop, stop, __ATOMIC_RELAXED);
+}
+
+static inline int searchStopRequested(void) {
+    return __atomic_load_n(&searchStop, __ATOMIC_RELAXED);
+}
+
+// 📘 라인 하나의 점수: 한 칸만 더 채우면 이기는 열린 라인 (O는 AI, X는 플레이어)
+static inline int lineValue(int lineX, int lineO) {
+    if (lineO == KWIN - 1 && lineX == 0) return 5;
+    if (lineX == KWIN - 1 && lineO == 0) return -5;
+    return 0;
+}
+
+// 📘 휴리스틱 평가 함수 (보드 전체를 다시 세는 기준 구현)
+static inline int evaluateHeuristic(const Board *board, int depth) {
+    char winner = checkWin(board);
+    if (winner == 'O') return WIN_SCORE - depth;
+    if (winner == 'X') return depth - WIN_SCORE;
+
+    int score = 0;
+    // 각 k칸 라인(가로, 세로, 대각선)에 대해 평가
+    for (int i = 0; i < lineCount; i++) {
+        int lineO = __builtin_popcountll(board->o & lineMasks[i]);
+        int lineX = __builtin_popcountll(board->x & lineMasks[i]);
+
+        score += lineValue(lineX, lineO);
+    }
+
+    return score;
+}
+
+// 📘 라인별 X/O 개수를 들고 다니며 수를 둘 때/무를 때 그 칸을 지나는 라인만 고친다.
+// 평가 점수와 승패 판정이 O(그 칸의 라인 수)로 나온다. (탐색 스레드마다 따로)
+typedef struct {
+    unsigned char countX[MAX_LINES];
+    unsigned char countO[MAX_LINES];
+    int score;                  // lineValue 의 합
+    int winsX, winsO;           // 완성된 라인 수
+} LineState;
+
+static _Thread_local LineState lineState;
+
+// 📘 현재 보드로 라인 상태를 처음부터 채운다 (루트에서 한 번)
+static inline void initLineState(const Board *board) {
+    LineState *ls = &lineState;
+    ls->score = ls->winsX = ls->winsO = 0;
+    for (int i = 0; i < lineCount; i++) {
+        ls->countX[i] = (unsigned char)__builtin_popcountll(board->x & lineMasks[i]);
+        ls->countO[i] = (unsigned char)__builtin_popcountll(board->o & lineMasks[i]);
+        ls->score += lineValue(ls->countX[i], ls->countO[i]);
+        if (ls->countX[i] == KWIN) ls->winsX++;
+        if (ls->countO[i] == KWIN) ls->winsO++;
+    }
+}
+
+// 📘 수 두기: 마스크와 그 칸을 지나는 라인의 개수/점수만 갱신
+static inline void makeMove(Board *board, int cell, int isO) {
+    LineState *ls = &lineState;
+    if (isO) board->o |= 1ull << cell;
+    else board->x |= 1ull << cell;
+
+    for (int i = cellLineStart[cell]; i < cellLineStart[cell + 1]; i++) {
+        int l = cellLineList[i];
+        ls->score -= lineValue(ls->countX[l], ls->countO[l]);
+        if (isO) { if (++ls->countO[l] == KWIN) ls->winsO++; }
+        else     { if (++ls->countX[l] == KWIN) ls->winsX++; }
+        ls->score += lineValue(ls->countX[l], ls->countO[l]);
+    }
+}
+
+// 📘 수 무르기: makeMove 의 반대
+static inline void unmakeMove(Board *board, int cell, int isO) {
+    LineState *ls = &lineState;
+    if (isO) board->o &= ~(1ull << cell);
+    else board->x &= ~(1ull << cell);
+
+    for (int i = cellLineStart[cell]; i < cellLineStart[cell + 1]; i++) {
+        int l = cellLineList[i];
+        ls->score -= lineValue(ls->countX[l], ls->countO[l]);
+        if (isO) { if (ls->countO[l]-- == KWIN) ls->winsO--; }
+        else     { if (ls->countX[l]-- == KWIN) ls->winsX--; }
+        ls->score += lineValue(ls->countX[l], ls->countO[l]);
+    }
+}
+
+// 📘 라인 상태로 바로 읽는 평가 점수 (evaluateHeuristic 과 같은 값)
+static inline int incrementalScore(int depth) {
+    if (lineState.winsX) return depth - WIN_SCORE;
+    if (lineState.winsO) return WIN_SCORE - depth;
+    return lineState.score;
+}
+
+
+// 📘 수 정렬: 전치표 최선 수 → 킬러 수 → history 점수 → 칸의 기본 가치(중앙, 모서리 우선)
+// 일찍 좋은 수를 읽을수록 가지치기가 빨리 일어난다. (스레드마다 따로)
+static _Thread_local signed char killers[MAX_CELLS][2];     // 깊이별로 가지치기를 일으킨 수 2개
+static _Thread_local unsigned int history[2][MAX_CELLS];    // [O 차례인가][칸] 가지치기 기여도
+
+// 새 수를 찾기 전에 킬러는 지우고 history 는 절반으로 줄인다
+static inline void resetMoveOrdering(void) {
+    for (int d = 0; d < MAX_CELLS; d++)
+        killers[d][0] = killers[d][1] = -1;
+    for (int cell = 0; cell < MAX_CELLS; cell++) {
+        history[0][cell] >>= 1;
+        history[1][cell] >>= 1;
+    }
+}
+
+// 킬러와 history 를 모두 지운다 (이전 탐색의 영향 없이 시작할 때)
+static inline void clearMoveOrdering(void) {
+    memset(history, 0, sizeof(history));
+    resetMoveOrdering();
+}
+
+// 빈 칸을 정렬 점수가 높은 순서로 moves 에 채우고 개수를 돌려준다 (같은 점수는 칸 번호 순)
+static inline int orderMoves(const Board *board, int isO, int ttMove, const signed char *killer, int *moves) {
+    long long keys[MAX_CELLS];
+    int n = 0;
+    for (Mask empty = emptyMask(board); empty; empty &= empty - 1) {
+        int cell = __builtin_ctzll(empty);
+        long long key = (long long)history[isO][cell] * 256 + cellWeight[cell];
+        if (cell == ttMove) key += 1LL << 52;
+        if (killer && cell == killer[0]) key += 1LL << 51;
+        if (killer && cell == killer[1]) key += 1LL << 50;
+
+        int i = n++;
+        while (i > 0 && keys[i - 1] < key) {
+            keys[i] = keys[i - 1];
+            moves[i] = moves[i - 1];
+            i--;
+        }
+        keys[i] = key;
+        moves[i] = cell;
+    }
+    return n;
+}
+
+// 가지치기를 일으킨 수를 킬러/history 에 기록
+static inline void recordCutoff(int depth, int isO, int cell, int moveIndex, int draft) {
+    betaCutoffs++;
+    if (moveIndex == 0) firstMoveCutoffs++;
+    if (killers[depth][0] != cell) {
+        killers[depth][1] = killers[depth][0];
+        killers[depth][0] = (signed char)cell;
+    }
+    history[isO][cell] += (unsigned int)(draft * draft);
+}
+
+// 📘 알파베타 가지치기 기반 minimax (비트보드 위에서 직접 탐색)
+static inline int minimaxAlphaBeta(Board *board, int depth, int isMaximizing, int alpha, int beta) {
+    searchNodes++;
+
+    // ⏱️ 1024 노드마다 시간 예산과 중단 요청 확인, 걸리면 이 반복은 버린다
+    if ((searchNodes & 1023) == 0 &&
+        (searchStopRequested() || (searchDeadline > 0 && nowMs() >= searchDeadline)))
+        searchAborted = 1;
+    if (searchAborted)
+        return 0;
+    STATS(searchStats.nodesAtDepth[depth + 1]++);
+
+    // 점수와 승패 판정은 라인 상태에서 바로 읽는다 (보드 재검사 없음)
+    int score = incrementalScore(depth);
+
+    if (lineState.winsO || lineState.winsX || isFull(board)) {
+        STATS(searchStats.terminalHits++);
+        return score;
+    }
+    if (depth >= searchDepthLimit) {
+        STATS(searchStats.horizonHits++);
+        return score;
+    }
+
+    // 🗂️ 전치표 조회: 대칭 정규화 키, 남은 깊이가 충분할 때만 쓰고 경계값이면 창을 좁힌다
+    int alphaOrig = alpha, betaOrig = beta;
+    int draft = searchDepthLimit - depth;
+    int sym, ttMove = -1;
+    unsigned long long key = canonicalKey(board, isMaximizing, &sym) ^ TT_TAG_ALPHABETA;
+    TTEntry entry;
+    if (ttProbe(key, &entry)) {
+        if (entry.move >= 0) ttMove = symInv[sym][entry.move];   // 깊이가 모자라도 수 정렬에는 쓴다
+        if (entry.draft >= draft) {
+            int value = scoreFromTT(entry.value, depth, WIN_SCORE);
+            if (entry.flag == TT_EXACT) return value;
+            if (entry.flag == TT_LOWER && value > alpha) alpha = value;
+            if (entry.flag == TT_UPPER && value < beta) beta = value;
+            if (beta <= alpha) return value;
+        }
+    }
+
+    int moves[MAX_CELLS];
+    int n = orderMoves(board, isMaximizing, ttMove, killers[depth], moves);
+    int best = isMaximizing ? -INF_SCORE : INF_SCORE, bestCell = -1;
+    STATS(searchStats.expandedNodes++);
+
+    for (int i = 0; i < n; i++) {
+        int cell = moves[i];
+        makeMove(board, cell, isMaximizing);
+        int val = minimaxAlphaBeta(board, depth + 1, !isMaximizing, alpha, beta);
+        unmakeMove(board, cell, isMaximizing);
+
+        if (isMaximizing) {
+            if (val > best) { best = val; bestCell = cell; }
+            if (best > alpha) alpha = best;
+        } else {
+            if (val < best) { best = val; bestCell = cell; }
+            if (best < beta) beta = best;
+        }
+        if (beta <= alpha) { // ✂️ 가지치기
+            recordCutoff(depth, isMaximizing, cell, i, draft);
+            STATS(searchStats.cutoffAtIndex[i]++);
+            break;
+        }
+    }
+    if (searchAborted)
+        return 0;
+
+    // 원래 창 밖의 값은 경계값으로 저장
+    int flag = TT_EXACT;
+    if (best <= alphaOrig) flag = TT_UPPER;
+    else if (best >= betaOrig) flag = TT_LOWER;
+    ttStore(key, scoreToTT(best, depth, WIN_SCORE), flag, draft, bestCell >= 0 ? symCell[sym][bestCell] : -1);
+    return best;
+}
+
+// 루트 수 하나를 앞선 최선 값(bestScore, bestCell)을 창으로 삼아 읽는다.
+// 칸 번호가 더 작은 수는 "같은 값"까지 확인해야 하므로 창을 1 넓힌다.
+static inline int searchRootMove(Board *board, int oTurn, int cell, int bestScore, int bestCell) {
+    int bound = bestScore;
+    if (bestCell >= 0 && cell < bestCell) bound += oTurn ? -1 : 1;
+
+    STATS_TIMER(moveStart);
+    makeMove(board, cell, oTurn);
+    int moveScore = oTurn ? minimaxAlphaBeta(board, 0, 0, bound, INF_SCORE)
+                          : minimaxAlphaBeta(board, 0, 1, -INF_SCORE, bound);
+    unmakeMove(board, cell, oTurn);
+    STATS(searchStats.rootMoveMs[cell] += nowMs() - moveStart);
+    return moveScore;
+}
+
+// 루트 최선 수 갱신 규칙: 값이 더 좋거나, 같으면 칸 번호가 작은 수
+static inline int rootMoveWins(int oTurn, int score, int cell, int bestScore, int bestCell) {
+    if (bestCell < 0) return 1;
+    if (score != bestScore) return oTurn ? score > bestScore : score < bestScore;
+    return cell < bestCell;
+}
+
+// 📘 루트 탐색: side 쪽의 최선 수 칸 번호 (루트 수를 포함해 depthLimit + 1 수까지 읽는다)
+// firstCell(이전 반복의 최선 수)부터 읽고, 앞선 최선 값을 창으로 넘겨 뒤의 수는 더 좋은지만 확인한다.
+// 값이 같으면 칸 번호가 작은 수를 고르므로 읽는 순서와 상관없이 같은 수가 나온다.
+static inline int searchRootAlphaBeta(Board *board, char side, int depthLimit, int firstCell, int *scoreOut) {
+    int oTurn = (side == 'O');
+    int bestScore = oTurn ? -INF_SCORE : INF_SCORE, bestCell = -1;
+    int moves[MAX_CELLS];
+
+    searchDepthLimit = depthLimit;
+    initLineState(board);
+    int n = orderMoves(board, oTurn, firstCell, NULL, moves);
+    for (int i = 0; i < n; i++) {
+        int cell = moves[i];
+        int moveScore = searchRootMove(board, oTurn, cell, bestScore, bestCell);
+        if (searchAborted) break;
+        if (rootMoveWins(oTurn, moveScore, cell, bestScore, bestCell)) {
+            bestScore = moveScore;
+            bestCell = cell;
+        }
+    }
+    if (scoreOut) *scoreOut = bestScore;
+    return bestCell;
+}
+
+// 📘 끝까지 읽는 루트 탐색 (시간 제한 없음)
+static inline int bestMoveAlphaBeta(Board *board, char side) {
+    resetMoveOrdering();
+    return searchRootAlphaBeta(board, side, MAX_CELLS, -1, NULL);
+}
+
+// ───────── 병렬 루트 탐색 (스레드 풀) ─────────
+// 루트 수를 작업 단위로 나눠 워커들이 하나씩 가져가 읽는다 (root splitting).
+// 모든 스레드가 락 없는 공용 전치표를 같이 쓰고, 루트 최선 값만 잠금으로 갱신한다.
+// 갱신 규칙이 직렬 탐색과 같으므로 (최고 값, 같으면 낮은 칸) 직렬과 같은 수를 고른다.
+
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t wake, done;
+    int threads;                // 호출 스레드를 포함한 탐색 스레드 수
+    int generation;             // 새 작업이 올라올 때마다 1 증가
+    int running;                // 아직 작업 중인 워커 수
+
+    // 현재 작업 (루트 한 번 = 반복 심화의 한 반복)
+    Board board;
+    int oTurn, depthLimit, freshOrdering;
+    double deadline;
+    int moves[MAX_CELLS], moveCount, nextMove;
+    int bestScore, bestCell, aborted;
+    long nodes, hits, misses, cutoffs, firstCutoffs;    // 워커 통계 합계
+#ifdef TTT_STATS
+    SearchStats stats;
+#endif
+} SearchPool;
+
+static SearchPool searchPool = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .wake = PTHREAD_COND_INITIALIZER,
+    .done = PTHREAD_COND_INITIALIZER,
+    .threads = 1,
+};
+
+// 한 스레드 몫: 남은 루트 수가 없을 때까지 하나씩 가져와 읽는다
+static void runPoolJob(SearchPool *p) {
+    Board board = p->board;
+    searchDepthLimit = p->depthLimit;
+    searchDeadline = p->deadline;
+    searchAborted = 0;
+    initLineState(&board);
+
+    while (1) {
+        pthread_mutex_lock(&p->lock);
+        if (p->aborted || p->nextMove >= p->moveCount) {
+            pthread_mutex_unlock(&p->lock);
+            break;
+        }
+        int cell = p->moves[p->nextMove++];
+        int bestScore = p->bestScore, bestCell = p->bestCell;
+        pthread_mutex_unlock(&p->lock);
+
+        int moveScore = searchRootMove(&board, p->oTurn, cell, bestScore, bestCell);
+
+        pthread_mutex_lock(&p->lock);
+        if (searchAborted) p->aborted = 1;
+        else if (rootMoveWins(p->oTurn, moveScore, cell, p->bestScore, p->bestCell)) {
+            p->bestScore = moveScore;
+            p->bestCell = cell;
+        }
+        pthread_mutex_unlock(&p->lock);
+        if (searchAborted) break;
+    }
+}
+
+static TTSlot *poolTable;       // 풀 스레드들이 같이 쓰는 전치표
+
+static void *poolWorker(void *arg) {
+    SearchPool *p = arg;
+    int seen = 0;
+    ttShared = poolTable;
+
+    pthread_mutex_lock(&p->lock);
+    while (1) {
+        while (p->generation == seen)
+            pthread_cond_wait(&p->wake, &p->lock);
+        seen = p->generation;
+        pthread_mutex_unlock(&p->lock);
+
+        resetSearchStats();
+        if (p->freshOrdering) resetMoveOrdering();
+        runPoolJob(p);
+
+        pthread_mutex_lock(&p->lock);
+        p->nodes += searchNodes;
+        p->hits += ttHits;
+        p->misses += ttMisses;
+        p->cutoffs += betaCutoffs;
+        p->firstCutoffs += firstMoveCutoffs;
+        STATS(mergeSearchStats(&p->stats, &searchStats));
+        if (--p->running == 0)
+            pthread_cond_signal(&p->done);
+    }
+    return NULL;
+}
+
+// 📘 탐색 스레드 풀 시작 (호출 스레드 포함 threads 개, 1 이하면 직렬 탐색 그대로)
+// 프로그램이 끝날 때까지 유지한다. 이 함수를 부른 스레드도 공용 전치표를 쓰게 된다.
+static inline int startSearchPool(int threads) {
+    if (threads <= 1 || searchPool.threads > 1) return searchPool.threads;
+    if (threads > MAX_CELLS) threads = MAX_CELLS;
+
+    poolTable = calloc(TT_SIZE, sizeof(TTSlot));
+    if (!poolTable) return 1;
+    ttShared = poolTable;
+    for (int t = 1; t < threads; t++) {
+        pthread_t tid;
+        if (pthread_create(&tid, NULL, poolWorker, &searchPool) != 0) break;
+        pthread_detach(tid);
+        searchPool.threads++;
+    }
+    return searchPool.threads;
+}
+
+// 📘 병렬 루트 탐색: searchRootAlphaBeta 와 같은 결과를 풀 전체로 계산
+static inline int searchRootParallel(Board *board, char side, int depthLimit, int firstCell,
+                                     int freshOrdering, int *scoreOut) {
+    SearchPool *p = &searchPool;
+    int oTurn = (side == 'O');
+
+    pthread_mutex_lock(&p->lock);
+    p->board = *board;
+    p->oTurn = oTurn;
+    p->depthLimit = depthLimit;
+    p->freshOrdering = freshOrdering;
+    p->deadline = searchDeadline;
+    p->moveCount = orderMoves(board, oTurn, firstCell, NULL, p->moves);
+    p->nextMove = 0;
+    p->bestScore = oTurn ? -INF_SCORE : INF_SCORE;
+    p->bestCell = -1;
+    p->aborted = 0;
+    p->nodes = p->hits = p->misses = p->cutoffs = p->firstCutoffs = 0;
+    STATS(memset(&p->stats, 0, sizeof(p->stats)));
+    p->running = p->threads - 1;
+    p->generation++;
+    pthread_cond_broadcast(&p->wake);
+    pthread_mutex_unlock(&p->lock);
+
+    // 호출 스레드도 워커 하나로 참여
+    runPoolJob(p);
+
+    pthread_mutex_lock(&p->lock);
+    while (p->running > 0)
+        pthread_cond_wait(&p->done, &p->lock);
+    searchNodes += p->nodes;
+    ttHits += p->hits;
+    ttMisses += p->misses;
+    betaCutoffs += p->cutoffs;
+    firstMoveCutoffs += p->firstCutoffs;
+    STATS(mergeSearchStats(&searchStats, &p->stats));
+    searchAborted = p->aborted;
+    int bestCell = p->bestCell;
+    if (scoreOut) *scoreOut = p->bestScore;
+    pthread_mutex_unlock(&p->lock);
+    return bestCell;
+}
+
+// 📘 반복 심화: 깊이를 1수씩 늘리다 예산(ms)을 넘기면 멈추고,
+// 마지막으로 끝까지 마친 깊이의 최선 수를 돌려준다 (budgetMs <= 0 이면 제한 없음, 빈 칸이 없으면 -1)
+static inline int iterativeDeepening(Board *board, char side, int budgetMs, int *depthDone) {
+    int empties = __builtin_popcountll(emptyMask(board));
+    if (empties == 0) {
+        if (depthDone) *depthDone = 0;
+        return -1;
+    }
+    int bestCell = __builtin_ctzll(emptyMask(board));   // 한 수도 못 읽었을 때의 대비
+    int completed = 0;
+
+    searchAborted = 0;
+    searchDeadline = budgetMs > 0 ? nowMs() + budgetMs : 0;
+    resetMoveOrdering();
+    for (int d = 1; d <= empties; d++) {
+        int score;
+        int firstCell = completed ? bestCell : -1;
+        int cell = searchPool.threads > 1
+                 ? searchRootParallel(board, side, d - 1, firstCell, d == 1, &score)
+                 : searchRootAlphaBeta(board, side, d - 1, firstCell, &score);
+        if (searchAborted) break;
+        bestCell = cell;
+        completed = d;
+        if (score >= WIN_SCORE - CELLS || score <= CELLS - WIN_SCORE)
+            break;                                  // 승패가 확정되면 더 읽을 필요 없음
+    }
+    searchDeadline = 0;
+    searchAborted = 0;
+
+    if (depthDone) *depthDone = completed;
+    return bestCell;
+}
+
+// ───────── 랜덤 엔진 ─────────
+
+// 빈 칸 중 하나를 고르게 선택 (스레드마다 시드를 따로 쓰도록 rand_r 사용)
+static inline int randomMove(const Board *b, unsigned int *seed) {
+    Mask empty = emptyMask(b);
+    for (int k = rand_r(seed) % __builtin_popcountll(empty); k > 0; k--)
+        empty &= empty - 1;
+    return __builtin_ctzll(empty);
+}
+
+// 보드 출력 함수
+static inline void printBoard(const Board *b) {
+    printf("\n");
+    for (int i = 0; i < ROWS; i++) {
+        for (int j = 0; j < COLS; j++) {
+            printf(" %c ", cellAt(b, i, j));
+            if (j < COLS - 1)
+                printf("|");
+        }
+        printf("\n");
+        if (i < ROWS - 1) {
+            for (int j = 0; j < COLS; j++)
+                printf(j < COLS - 1 ? "---+" : "---\n");
+        }
+    }
+    printf("\n");
+}
+
+#endif
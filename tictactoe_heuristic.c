@@ -1,230 +1,209 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
-
-#define SIZE 3
-
-// 📘 보드 출력 함수
-void printBoard(char board[SIZE][SIZE]) {
-    printf("\n");
-    for (int i = 0; i < SIZE; i++) {
-        for (int j = 0; j < SIZE; j++) {
-            printf(" %c ", board[i][j]);
-            if (j < SIZE - 1)
-                printf("|");
-        }
-        printf("\n");
-        if (i < SIZE - 1)
-            printf("---+---+---\n");
+#include <unistd.h>
+#include <pthread.h>
+
+#include "tictactoe_engine.h"
+
+// 📘 완전 해 테이블 모드 (실행 인자 --table)
+int useTable = 0;
+
+// 📘 한 수당 탐색 시간 예산 (ms)
+int moveBudgetMs = 1000;
+
+// 📘 탐색 스레드 수 (실행 인자 --threads N, 0 이면 모든 코어)
+int searchThreads = 1;
+
+// 📘 생각 미리 하기 모드 (실행 인자 --ponder): 사람이 고민하는 동안 다음 수를 미리 읽는다
+int usePonder = 0;
+
+// 📘 생각 미리 하기 상태: 상대의 응수를 예측해 둔 국면에서 컴퓨터의 수를 찾는다
+typedef struct {
+    Board board;            // 컴퓨터가 방금 둔 국면
+    TTSlot *table;          // 메인 스레드의 전치표 (미리 읽은 결과를 그대로 쓰도록)
+    int predicted;          // 예측한 상대의 수 (-1 이면 예측 못 함)
+    int bestCell;           // 예측 국면에서 찾은 수 (-1 이면 못 찾음)
+    int depthDone;
+    int finished;           // 중단 전에 탐색이 끝났는가
+    double searchMs;        // 예측 국면을 읽은 시간
+    int running;
+    pthread_t thread;
+} Ponder;
+
+// 📘 아직 미리 읽은 것이 없는 상태 (쓰고 난 뒤에도 이것으로 되돌린다)
+#define PONDER_NONE ((Ponder){ .predicted = -1, .bestCell = -1 })
+
+Ponder ponder = { .predicted = -1, .bestCell = -1 };
+
+// 📘 생각 미리 하기 스레드: 예산의 1/4 로 상대 응수를 예측하고, 그 국면을 중단될 때까지 읽는다
+void *ponderWorker(void *arg) {
+    Ponder *p = arg;
+    Board b = p->board;
+    ttShared = p->table;
+
+    p->predicted = iterativeDeepening(&b, 'X', moveBudgetMs / 4, NULL);
+    if (searchStopRequested()) {
+        p->predicted = -1;
+        return NULL;
     }
-    printf("\n");
+    b.x |= 1ull << p->predicted;
+    if (checkWin(&b) != ' ' || isFull(&b)) return NULL;
+
+    double start = nowMs();
+    p->bestCell = iterativeDeepening(&b, 'O', 0, &p->depthDone);
+    p->finished = !searchStopRequested();
+    p->searchMs = nowMs() - start;
+    return NULL;
 }
 
-// 📘 승자 판별 함수
-char checkWin(char board[SIZE][SIZE]) {
-    // 행 검사
-    for (int i = 0; i < SIZE; i++) {
-        if (board[i][0] != ' ' &&
-            board[i][0] == board[i][1] &&
-            board[i][1] == board[i][2])
-            return board[i][0];
-    }
-    // 열 검사
-    for (int i = 0; i < SIZE; i++) {
-        if (board[0][i] != ' ' &&
-            board[0][i] == board[1][i] &&
-            board[1][i] == board[2][i])
-            return board[0][i];
-    }
-    // 대각선 검사
-    if (board[0][0] != ' ' &&
-        board[0][0] == board[1][1] &&
-        board[1][1] == board[2][2])
-        return board[0][0];
-    if (board[0][2] != ' ' &&
-        board[0][2] == board[1][1] &&
-        board[1][1] == board[2][0])
-        return board[0][2];
-
-    return ' '; // 승자 없음
+// 📘 컴퓨터가 둔 뒤 생각 미리 하기 시작
+void startPonder(const Board *board) {
+    ponder = PONDER_NONE;
+    ponder.board = *board;
+    ponder.table = currentTable();
+    ponder.running = pthread_create(&ponder.thread, NULL, ponderWorker, &ponder) == 0;
 }
 
-// 📘 보드가 가득 찼는지 확인
-int isFull(char board[SIZE][SIZE]) {
-    for (int i = 0; i < SIZE; i++)
-        for (int j = 0; j < SIZE; j++)
-            if (board[i][j] == ' ')
-                return 0;
-    return 1;
+// 📘 상대의 수가 들어오면 중단 플래그를 세우고 스레드가 끝나기를 기다린다
+void stopPonder(void) {
+    if (!ponder.running) return;
+    requestSearchStop(1);
+    pthread_join(ponder.thread, NULL);
+    requestSearchStop(0);
+    ponder.running = 0;
 }
 
-// 📘 휴리스틱 평가 함수
-int evaluateHeuristic(char board[SIZE][SIZE], int depth) {
-    char winner = checkWin(board);
-    if (winner == 'O') return 100 - depth;
-    if (winner == 'X') return depth - 100;
-
-    int score = 0;
-    // 각 행, 열, 대각선에 대해 평가
-    for (int i = 0; i < SIZE; i++) {
-        int rowX = 0, rowO = 0;
-        int colX = 0, colO = 0;
-
-        for (int j = 0; j < SIZE; j++) {
-            if (board[i][j] == 'X') rowX++;
-            if (board[i][j] == 'O') rowO++;
-            if (board[j][i] == 'X') colX++;
-            if (board[j][i] == 'O') colO++;
-        }
-
-        // O는 AI, X는 플레이어
-        if (rowO == 2 && rowX == 0) score += 5;
-        if (colO == 2 && colX == 0) score += 5;
-        if (rowX == 2 && rowO == 0) score -= 5;
-        if (colX == 2 && colO == 0) score -= 5;
+// 📘 최적의 수 찾기
+void findBestMove(Board *board) {
+    if (useTable) {
+        PerfectEntry e = perfectLookup(board); // ⚡ O(1) 조회
+        board->o |= 1ull << e.cell;
+        printf("🤖 컴퓨터가 (%d, %d)에 둡니다.\n", e.cell / COLS + 1, e.cell % COLS + 1);
+        printf("📖 완전 해 테이블 조회 (게임 이론 값 %d)\n", e.value);
+        return;
     }
 
-    // 대각선 평가
-    int diag1O = 0, diag1X = 0;
-    int diag2O = 0, diag2X = 0;
-    for (int i = 0; i < SIZE; i++) {
-        if (board[i][i] == 'O') diag1O++;
-        if (board[i][i] == 'X') diag1X++;
-        if (board[i][SIZE - i - 1] == 'O') diag2O++;
-        if (board[i][SIZE - i - 1] == 'X') diag2X++;
+    // ⏱️ 반복 심화: 예산 안에 마친 가장 깊은 탐색의 수를 둔다
+    int depthDone = 0, budgetMs = moveBudgetMs;
+    double start = nowMs();
+    resetSearchStats();
+
+    // 🔮 예측이 맞았으면 미리 읽은 만큼 예산에서 빼고, 다 썼으면 그 수를 바로 둔다
+    // (예산이 0 이면 제한 없음이라, 끝까지 읽은 경우만 그대로 둔다)
+    Ponder used = ponder;
+    ponder = PONDER_NONE;
+    if (usePonder && used.predicted >= 0 && used.bestCell >= 0 &&
+        (used.board.x | 1ull << used.predicted) == board->x && used.board.o == board->o) {
+        printf("🔮 예측 적중: 상대 차례에 %d수 깊이까지 미리 탐색 (%.0fms)\n",
+               used.depthDone, used.searchMs);
+        if (used.finished || (moveBudgetMs > 0 && used.searchMs >= moveBudgetMs)) {
+            board->o |= 1ull << used.bestCell;
+            printf("🤖 컴퓨터가 (%d, %d)에 둡니다.\n", used.bestCell / COLS + 1, used.bestCell % COLS + 1);
+            return;
+        }
+        if (moveBudgetMs > 0)
+            budgetMs = moveBudgetMs - (int)used.searchMs;   // 전치표가 데워져 있어 앞 깊이는 금방 지나간다
     }
-    if (diag1O == 2 && diag1X == 0) score += 5;
-    if (diag2O == 2 && diag2X == 0) score += 5;
-    if (diag1X == 2 && diag1O == 0) score -= 5;
-    if (diag2X == 2 && diag2O == 0) score -= 5;
+    int bestCell = iterativeDeepening(board, 'O', budgetMs, &depthDone);
 
-    return score;
+    board->o |= 1ull << bestCell;
+    printf("🤖 컴퓨터가 (%d, %d)에 둡니다.\n", bestCell / COLS + 1, bestCell % COLS + 1);
+    printf("🔍 %d수 깊이까지 탐색 (%.0fms)\n", depthDone, nowMs() - start);
+    printSearchStats();
+    printSearchLog();
 }
 
+// 📘 메인 함수
+// 실행 인자: [--table] [--threads N] [--ponder] [행 열 k [한 수당 ms]]  (예: --threads 8 --ponder 7 6 4 500)
+int main(int argc, char *argv[]) {
+    Board board;
+    initBoard(&board);
 
-// 📘 알파베타 가지치기 기반 minimax
-int minimaxAlphaBeta(char board[SIZE][SIZE], int depth, int isMaximizing, int alpha, int beta) {
-    int score = evaluateHeuristic(board, depth);
-    char winner = checkWin(board);
-
-    if (winner == 'O' || winner == 'X' || isFull(board))
-        return score;
-
-    if (isMaximizing) {
-        int best = -1000;
-        for (int i = 0; i < SIZE; i++) {
-            for (int j = 0; j < SIZE; j++) {
-                if (board[i][j] == ' ') {
-                    board[i][j] = 'O';
-                    int val = minimaxAlphaBeta(board, depth + 1, 0, alpha, beta);
-                    board[i][j] = ' ';
-                    if (val > best) best = val;
-                    if (best > alpha) alpha = best;
-                    if (beta <= alpha) return best; // ✂️ 가지치기
-                }
-            }
-        }
-        return best;
-    } else {
-        int best = 1000;
-        for (int i = 0; i < SIZE; i++) {
-            for (int j = 0; j < SIZE; j++) {
-                if (board[i][j] == ' ') {
-                    board[i][j] = 'X';
-                    int val = minimaxAlphaBeta(board, depth + 1, 1, alpha, beta);
-                    board[i][j] = ' ';
-                    if (val < best) best = val;
-                    if (best < beta) beta = best;
-                    if (beta <= alpha) return best; // ✂️ 가지치기
-                }
-            }
-        }
-        return best;
-    }
-}
+    srand((unsigned int)time(NULL));
 
+    // 📘 실행 인자 읽기
+    int args[4] = { 3, 3, 3, 1000 }, nArgs = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--table") == 0) useTable = 1;
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) searchThreads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--ponder") == 0) usePonder = 1;
+        else if (nArgs < 4) args[nArgs++] = atoi(argv[i]);
+    }
+    if (!initGeometry(args[0], args[1], args[2])) {
+        printf("❌ 지원하지 않는 보드입니다. (행, 열 3 이상, 칸 수 64 이하, 3 <= k <= max(행, 열))\n");
+        return 1;
+    }
+    moveBudgetMs = args[3];
 
-// 📘 최적의 수 찾기
-void findBestMove(char board[SIZE][SIZE]) {
-    int bestScore = -1000;
-    int bestRow = -1, bestCol = -1;
-
-    for (int i = 0; i < SIZE; i++) {
-        for (int j = 0; j < SIZE; j++) {
-            if (board[i][j] == ' ') {
-                board[i][j] = 'O';
-                int moveScore = minimaxAlphaBeta(board, 0, 0, -1000, 1000);
-                board[i][j] = ' ';
-                if (moveScore > bestScore) {
-                    bestScore = moveScore;
-                    bestRow = i;
-                    bestCol = j;
-                }
-            }
+    if (useTable) {
+        if (!initPerfectTable()) {
+            printf("❌ 완전 해 테이블은 3x3 (k=3) 보드에서만 쓸 수 있습니다.\n");
+            return 1;
         }
+        printf("📖 완전 해 테이블 준비 완료 (%d개 국면)\n", perfectPositions);
     }
 
-    board[bestRow][bestCol] = 'O';
-    printf("🤖 컴퓨터가 (%d, %d)에 둡니다.\n", bestRow + 1, bestCol + 1);
-}
-
-// 📘 메인 함수
-int main(void) {
-    char board[SIZE][SIZE];
-    for (int i = 0; i < SIZE; i++)
-        for (int j = 0; j < SIZE; j++)
-            board[i][j] = ' ';
-
-    srand((unsigned int)time(NULL));
+    // 🧵 병렬 탐색: 루트 수를 스레드 풀에 나눠 읽는다
+    if (searchThreads <= 0) searchThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (!useTable && searchThreads > 1)
+        printf("🧵 탐색 스레드 %d개\n", startSearchPool(searchThreads));
+    if (useTable) usePonder = 0;   // 테이블 조회는 O(1) 이라 미리 읽을 것이 없다
 
     char winner = ' ';
     int row, col;
 
     printf("🎮 틱택토 (플레이어 vs 컴퓨터)\n");
-    printf("당신은 X입니다. (1~3 사이의 행, 열을 입력하세요)\n");
-    printBoard(board);
+    printf("%dx%d 보드, %d개를 먼저 이으면 승리 (한 수당 %dms)\n", ROWS, COLS, KWIN, moveBudgetMs);
+    printf("당신은 X입니다. (1~%d 사이의 행, 1~%d 사이의 열을 입력하세요)\n", ROWS, COLS);
+    printBoard(&board);
 
     while (1) {
         // 🧍 플레이어 차례
         printf("플레이어 차례입니다. (행 열 입력): ");
         scanf("%d %d", &row, &col);
 
-        if (row < 1 || row > 3 || col < 1 || col > 3) {
-            printf("❌ 잘못된 입력입니다. 1~3 사이의 숫자를 입력하세요.\n");
+        if (row < 1 || row > ROWS || col < 1 || col > COLS) {
+            printf("❌ 잘못된 입력입니다. 행은 1~%d, 열은 1~%d 사이의 숫자를 입력하세요.\n", ROWS, COLS);
             continue;
         }
-        if (board[row - 1][col - 1] != ' ') {
+        if (cellAt(&board, row - 1, col - 1) != ' ') {
             printf("⚠️ 이미 둔 자리입니다!\n");
             continue;
         }
 
-        board[row - 1][col - 1] = 'X';
-        printBoard(board);
+        stopPonder();
+        placeMark(&board, row - 1, col - 1, 'X');
+        printBoard(&board);
 
-        winner = checkWin(board);
+        winner = checkWin(&board);
         if (winner == 'X') {
             printf("🎉 플레이어 승리!\n");
             break;
         }
-        if (isFull(board)) {
+        if (isFull(&board)) {
             printf("🤝 무승부입니다!\n");
             break;
         }
 
         // 💻 컴퓨터 차례
         printf("컴퓨터가 두는 중...\n");
-        findBestMove(board);
-        printBoard(board);
+        findBestMove(&board);
+        printBoard(&board);
 
-        winner = checkWin(board);
+        winner = checkWin(&board);
         if (winner == 'O') {
             printf("💻 컴퓨터 승리!\n");
             break;
         }
-        if (isFull(board)) {
+        if (isFull(&board)) {
             printf("🤝 무승부입니다!\n");
             break;
         }
+
+        // 🔮 사람이 고민하는 동안 다음 수를 미리 읽는다
+        if (usePonder) startPonder(&board);
     }
 
     printf("게임 종료!\n");